@@ -11,10 +11,11 @@ Animation::Animation()
 	flipped = false;
 }
 
-// Adds animation frame. Rect object represent a single sprite frame
+// Adds animation frame. Rect object represent a single sprite frame. The flipped version is stored alongside it.
 void Animation::addFrame(sf::IntRect rect)
 {
 	frames.push_back(rect);
+	flippedFrames.push_back(sf::IntRect(rect.left + rect.width, rect.top, -rect.width, rect.height));
 }
 
 // Returns the size of the animation. The number of frames.
@@ -26,13 +27,7 @@ int Animation::getSize()
 // Get current frame from the animation. Flip the returning frame if required.
 sf::IntRect Animation::getCurrentFrame()
 {
-	frame = frames[currentFrame];
-	if (flipped)
-	{
-
-		frame = sf::IntRect(frame.left + frame.width, frame.top, -frame.width, frame.height);
-	}
-	return frame;
+	return flipped ? flippedFrames[currentFrame] : frames[currentFrame];
 }
 
 // Check if the animation should progress, if so move to next frame, or loop back to the start
@@ -7,7 +7,7 @@
 #include "SFML\Graphics.hpp"
 #include <vector>
 
-class Animation: public sf::Sprite
+class Animation
 {
 public:
 	Animation();
@@ -38,7 +38,7 @@ public:
 
 protected:
 	std::vector<sf::IntRect>frames;
-	sf::IntRect frame;
+	std::vector<sf::IntRect>flippedFrames;
 	int currentFrame;
 	float animationSpeed;
 	bool flipped;
@@ -0,0 +1,199 @@
+#include "AnimationSystem.h"
+#include "SpriteSheet.h"
+#include <iostream>
+
+AnimationSystem::AnimationSystem()
+{
+}
+
+AnimationSystem::~AnimationSystem()
+{
+}
+
+ClipId AnimationSystem::addClip(const std::string& name, const std::vector<sf::IntRect>& frames, float frameDuration, LoopMode mode)
+{
+	AnimationClip clip;
+	clip.name = name;
+	clip.frames = frames;
+	clip.frameDuration = frameDuration;
+	clip.mode = mode;
+	return addClip(std::move(clip));
+}
+
+// Flipped frames are mirrored horizontally by using a negative width, as Animation::getCurrentFrame did.
+ClipId AnimationSystem::addClip(AnimationClip clip)
+{
+	if (clip.frames.empty() || clips.size() >= InvalidClip)
+	{
+		std::cerr << "Animation clip " << clip.name << " could not be added" << std::endl;
+		return InvalidClip;
+	}
+	clip.durations.resize(clip.frames.size(), clip.frameDuration);
+
+	ClipId existing = findClip(clip.name);
+	if (existing != InvalidClip)
+	{
+		const AnimationClip& other = clips[existing];
+		if (other.frames == clip.frames && other.durations == clip.durations && other.mode == clip.mode && other.texture == clip.texture)
+		{
+			return existing;
+		}
+		std::cerr << "Animation clip " << clip.name << " is already used by a different clip, not added" << std::endl;
+		return InvalidClip;
+	}
+
+	clip.flippedFrames.clear();
+	for (const sf::IntRect& frame : clip.frames)
+	{
+		clip.flippedFrames.push_back(sf::IntRect(frame.left + frame.width, frame.top, -frame.width, frame.height));
+	}
+
+	ClipId id = (ClipId)clips.size();
+	clipIds[clip.name] = id;
+	clips.push_back(std::move(clip));
+	return id;
+}
+
+const SpriteSheet* AnimationSystem::loadSpriteSheet(const std::string& path)
+{
+	auto it = sheets.find(path);
+	if (it != sheets.end())
+	{
+		return it->second.get();
+	}
+
+	auto sheet = std::make_unique<SpriteSheet>();
+	if (!sheet->loadFromFile(path))
+	{
+		return nullptr;
+	}
+	sheet->registerClips(*this);
+	const SpriteSheet* result = sheet.get();
+	sheets[path] = std::move(sheet);
+	return result;
+}
+
+ClipId AnimationSystem::findClip(const std::string& name) const
+{
+	auto it = clipIds.find(name);
+	if (it != clipIds.end())
+	{
+		return it->second;
+	}
+	return InvalidClip;
+}
+
+AnimationHandle AnimationSystem::create(ClipId clip)
+{
+	PlaybackState state;
+	state.elapsed = 0.f;
+	state.clip = clip;
+	state.frame = 0;
+	state.flags = ACTIVE | PLAYING;
+
+	if (!freeStates.empty())
+	{
+		AnimationHandle animation = freeStates.back();
+		freeStates.pop_back();
+		states[animation] = state;
+		return animation;
+	}
+	states.push_back(state);
+	return (AnimationHandle)states.size() - 1;
+}
+
+void AnimationSystem::destroy(AnimationHandle animation)
+{
+	if (animation >= states.size() || !(states[animation].flags & ACTIVE)) return;
+	states[animation].flags = 0;
+	freeStates.push_back(animation);
+}
+
+void AnimationSystem::play(AnimationHandle animation, ClipId clip)
+{
+	PlaybackState& state = states[animation];
+	if (state.clip != clip)
+	{
+		state.clip = clip;
+		state.frame = 0;
+		state.elapsed = 0.f;
+		state.flags &= ~REVERSE;
+	}
+	state.flags |= PLAYING;
+}
+
+void AnimationSystem::reset(AnimationHandle animation)
+{
+	states[animation].frame = 0;
+	states[animation].elapsed = 0.f;
+	states[animation].flags &= ~REVERSE;
+}
+
+void AnimationSystem::setPlaying(AnimationHandle animation, bool playing)
+{
+	if (playing) states[animation].flags |= PLAYING;
+	else states[animation].flags &= ~PLAYING;
+}
+
+bool AnimationSystem::isPlaying(AnimationHandle animation) const
+{
+	return (states[animation].flags & PLAYING) != 0;
+}
+
+void AnimationSystem::setFlipped(AnimationHandle animation, bool flipped)
+{
+	if (flipped) states[animation].flags |= FLIPPED;
+	else states[animation].flags &= ~FLIPPED;
+}
+
+bool AnimationSystem::isFlipped(AnimationHandle animation) const
+{
+	return (states[animation].flags & FLIPPED) != 0;
+}
+
+sf::IntRect AnimationSystem::getFrame(AnimationHandle animation) const
+{
+	const PlaybackState& state = states[animation];
+	const AnimationClip& clip = clips[state.clip];
+	return (state.flags & FLIPPED) ? clip.flippedFrames[state.frame] : clip.frames[state.frame];
+}
+
+// Move each playing animation on a frame once that frame's duration has passed.
+// Loop wraps to the start, Once stops on the last frame and PingPong reverses at either end.
+void AnimationSystem::update(float dt)
+{
+	for (PlaybackState& state : states)
+	{
+		if ((state.flags & (ACTIVE | PLAYING)) != (ACTIVE | PLAYING)) continue;
+
+		const AnimationClip& clip = clips[state.clip];
+		state.elapsed += dt;
+		if (state.elapsed < clip.durations[state.frame]) continue;
+		state.elapsed = 0.f;
+
+		unsigned short last = (unsigned short)(clip.frames.size() - 1);
+		switch (clip.mode)
+		{
+		case LoopMode::Loop:
+			state.frame = (state.frame >= last) ? 0 : state.frame + 1;
+			break;
+		case LoopMode::Once:
+			if (state.frame < last) state.frame++;
+			else state.flags &= ~PLAYING;
+			break;
+		case LoopMode::PingPong:
+			if (last == 0) break;
+			if (state.flags & REVERSE)
+			{
+				if (state.frame == 0) { state.flags &= ~REVERSE; state.frame = 1; }
+				else state.frame--;
+			}
+			else
+			{
+				if (state.frame >= last) { state.flags |= REVERSE; state.frame = last - 1; }
+				else state.frame++;
+			}
+			break;
+		}
+	}
+}
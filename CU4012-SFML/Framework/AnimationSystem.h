@@ -0,0 +1,95 @@
+// Animation System Class
+// Stores animation clips once and shares them between every object that plays them.
+// Clips are immutable after being added, and their flipped frames are worked out up front.
+// The playback state of every animated object is kept in one packed array and advanced in a single pass per frame.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+
+class SpriteSheet;
+
+typedef unsigned short ClipId;
+const ClipId InvalidClip = 0xFFFF;
+
+typedef unsigned int AnimationHandle;
+const AnimationHandle InvalidAnimation = 0xFFFFFFFF;
+
+enum class LoopMode : unsigned char { Loop, Once, PingPong };
+
+// A shared, read-only animation. Frame rects for both facing directions.
+// Clips loaded from a sprite sheet also carry the sheet texture.
+struct AnimationClip
+{
+	std::string name;
+	std::vector<sf::IntRect> frames;
+	std::vector<sf::IntRect> flippedFrames;
+	std::vector<float> durations;
+	float frameDuration = 0.f;
+	LoopMode mode = LoopMode::Loop;
+	const sf::Texture* texture = nullptr;
+};
+
+class AnimationSystem
+{
+public:
+	AnimationSystem();
+	~AnimationSystem();
+
+	// Add a clip. Frame duration is in seconds. Clip names are global, across every sprite sheet: adding an identical
+	// clip again returns the existing one, while a different clip with a name already in use is reported and not added.
+	ClipId addClip(const std::string& name, const std::vector<sf::IntRect>& frames, float frameDuration, LoopMode mode = LoopMode::Loop);
+	// Add a fully described clip. Missing per-frame durations default to frameDuration. Returns InvalidClip on failure.
+	ClipId addClip(AnimationClip clip);
+	// Returns InvalidClip if no clip has the name.
+	ClipId findClip(const std::string& name) const;
+	const AnimationClip& getClip(ClipId clip) const { return clips[clip]; }
+
+	// Load a sprite sheet descriptor and register its clips. Sheets are cached by path, so repeat calls are cheap.
+	// Returns nullptr if the sheet fails to load.
+	const SpriteSheet* loadSpriteSheet(const std::string& path);
+
+	// Create playback state for one object, starting on the given clip.
+	AnimationHandle create(ClipId clip);
+	void destroy(AnimationHandle animation);
+
+	// Switch clip. Playback restarts from the first frame only if the clip changes.
+	void play(AnimationHandle animation, ClipId clip);
+	void reset(AnimationHandle animation);
+	void setPlaying(AnimationHandle animation, bool playing);
+	bool isPlaying(AnimationHandle animation) const;
+	void setFlipped(AnimationHandle animation, bool flipped);
+	bool isFlipped(AnimationHandle animation) const;
+	ClipId getCurrentClip(AnimationHandle animation) const { return states[animation].clip; }
+
+	// Current frame rect, already flipped if required.
+	sf::IntRect getFrame(AnimationHandle animation) const;
+
+	// Advance every playing animation. Call once per frame.
+	void update(float dt);
+
+	int getAnimationCount() const { return (int)(states.size() - freeStates.size()); }
+
+private:
+	enum Flags : unsigned char { ACTIVE = 1, PLAYING = 2, FLIPPED = 4, REVERSE = 8 };
+
+	// Per-object playback state, kept small so update() walks a tight array
+	struct PlaybackState
+	{
+		float elapsed;
+		ClipId clip;
+		unsigned short frame;
+		unsigned char flags;
+	};
+
+	std::vector<AnimationClip> clips;
+	std::unordered_map<std::string, ClipId> clipIds;
+
+	std::vector<PlaybackState> states;
+	std::vector<AnimationHandle> freeStates;
+
+	std::unordered_map<std::string, std::unique_ptr<SpriteSheet>> sheets;
+};
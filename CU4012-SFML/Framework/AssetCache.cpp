@@ -0,0 +1,207 @@
+#include "AssetCache.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+AssetCache::AssetCache()
+{
+	std::error_code error;
+	if (fs::exists("assets.pack", error))
+	{
+		pack.open("assets.pack");
+	}
+	textureCache.open("cache/textures.cache");
+}
+
+AssetCache& AssetCache::get()
+{
+	static AssetCache cache;
+	return cache;
+}
+
+// Different spellings of the same file ("gfx/a.png", "./gfx/../gfx/a.png") map to one key
+std::string AssetCache::canonicalPath(const std::string& path)
+{
+	std::error_code error;
+	fs::path canonical = fs::weakly_canonical(fs::path(path), error);
+	if (error)
+	{
+		return fs::path(path).lexically_normal().generic_string();
+	}
+	return canonical.generic_string();
+}
+
+size_t AssetCache::fileSize(const std::string& path) const
+{
+	const char* data;
+	size_t packedSize;
+	if (pack.find(path, data, packedSize))
+	{
+		return packedSize;
+	}
+	std::error_code error;
+	uintmax_t size = fs::file_size(fs::path(path), error);
+	return error ? 0 : (size_t)size;
+}
+
+std::shared_ptr<sf::Texture> AssetCache::getTexture(const std::string& path)
+{
+	std::string key = canonicalPath(path);
+	auto it = textures.find(key);
+	if (it != textures.end())
+	{
+		return it->second.asset;
+	}
+
+	auto texture = std::make_shared<sf::Texture>();
+	if (!textureCache.loadTexture(path, *texture))
+	{
+		sf::Image image;
+		if (!loadAsset(image, path) || !texture->loadFromImage(image))
+		{
+			std::cerr << "Failed to load texture: " << path << std::endl;
+			return nullptr;
+		}
+		textureCache.store(path, std::move(image));
+	}
+	sf::Vector2u size = texture->getSize();
+	textures[key] = { texture, (size_t)size.x * size.y * 4 };
+	return texture;
+}
+
+std::shared_ptr<sf::Texture> AssetCache::findTexture(const std::string& path)
+{
+	auto it = textures.find(canonicalPath(path));
+	if (it != textures.end())
+	{
+		return it->second.asset;
+	}
+	return nullptr;
+}
+
+std::shared_ptr<sf::Texture> AssetCache::addTexture(const std::string& path, sf::Texture&& texture)
+{
+	std::string key = canonicalPath(path);
+	auto it = textures.find(key);
+	if (it != textures.end())
+	{
+		return it->second.asset;
+	}
+
+	auto handle = std::make_shared<sf::Texture>(std::move(texture));
+	sf::Vector2u size = handle->getSize();
+	textures[key] = { handle, (size_t)size.x * size.y * 4 };
+	return handle;
+}
+
+// sf::Font streams glyphs from the file as needed, so its file size is the best estimate available
+std::shared_ptr<sf::Font> AssetCache::getFont(const std::string& path)
+{
+	std::string key = canonicalPath(path);
+	auto it = fonts.find(key);
+	if (it != fonts.end())
+	{
+		return it->second.asset;
+	}
+
+	auto font = std::make_shared<sf::Font>();
+	if (!loadAsset(*font, path))
+	{
+		std::cerr << "Failed to load font: " << path << std::endl;
+		return nullptr;
+	}
+	fonts[key] = { font, fileSize(path) };
+	return font;
+}
+
+std::shared_ptr<sf::SoundBuffer> AssetCache::getSoundBuffer(const std::string& path)
+{
+	std::string key = canonicalPath(path);
+	auto it = soundBuffers.find(key);
+	if (it != soundBuffers.end())
+	{
+		return it->second.asset;
+	}
+
+	auto buffer = std::make_shared<sf::SoundBuffer>();
+	if (!loadAsset(*buffer, path))
+	{
+		std::cerr << "Failed to load sound: " << path << std::endl;
+		return nullptr;
+	}
+	soundBuffers[key] = { buffer, (size_t)buffer->getSampleCount() * sizeof(sf::Int16) };
+	return buffer;
+}
+
+template <typename T>
+int AssetCache::evict(std::unordered_map<std::string, Entry<T>>& entries)
+{
+	int removed = 0;
+	for (auto it = entries.begin(); it != entries.end();)
+	{
+		if (it->second.asset.use_count() == 1)
+		{
+			it = entries.erase(it);
+			removed++;
+		}
+		else
+		{
+			++it;
+		}
+	}
+	return removed;
+}
+
+int AssetCache::evictUnused()
+{
+	return evict(textures) + evict(fonts) + evict(soundBuffers);
+}
+
+void AssetCache::shutdown()
+{
+	int held = 0;
+	for (auto& entry : textures) if (entry.second.asset.use_count() > 1) held++;
+	for (auto& entry : fonts) if (entry.second.asset.use_count() > 1) held++;
+	for (auto& entry : soundBuffers) if (entry.second.asset.use_count() > 1) held++;
+	if (held > 0)
+	{
+		std::cerr << "Asset cache shut down with " << held << " assets still in use" << std::endl;
+	}
+	textures.clear();
+	fonts.clear();
+	soundBuffers.clear();
+	textureCache.wait(); // Finish writing the texture cache before the process exits
+}
+
+size_t AssetCache::getMemoryUsage() const
+{
+	size_t total = 0;
+	for (auto& entry : textures) total += entry.second.bytes;
+	for (auto& entry : fonts) total += entry.second.bytes;
+	for (auto& entry : soundBuffers) total += entry.second.bytes;
+	return total;
+}
+
+template <typename T>
+void AssetCache::report(std::ostream& out, const char* type, const std::unordered_map<std::string, Entry<T>>& entries, size_t& total)
+{
+	size_t subtotal = 0;
+	for (auto& entry : entries)
+	{
+		// The cache's own handle is not counted as a user
+		out << "  " << type << " " << entry.first << ": " << entry.second.bytes / 1024 << " KB, " << entry.second.asset.use_count() - 1 << " users" << std::endl;
+		subtotal += entry.second.bytes;
+	}
+	out << "  " << entries.size() << " " << type << "s, " << subtotal / 1024 << " KB" << std::endl;
+	total += subtotal;
+}
+
+void AssetCache::printReport(std::ostream& out) const
+{
+	size_t total = 0;
+	out << "Asset cache:" << std::endl;
+	report(out, "texture", textures, total);
+	report(out, "font", fonts, total);
+	report(out, "sound", soundBuffers, total);
+	out << "Total: " << total / 1024 << " KB" << std::endl;
+}
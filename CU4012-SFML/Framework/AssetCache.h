@@ -0,0 +1,90 @@
+// Asset Cache Class
+// One engine-wide store for textures, fonts and sound buffers.
+// Assets are keyed by canonical path, so the same file is only ever loaded once, and handed out as shared_ptr handles.
+// Entries nobody else holds a handle to can be evicted, and every entry reports its approximate memory use.
+// Main thread only.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include "SFML\Audio.hpp"
+#include "TextureCache.h"
+#include "AssetPack.h"
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <iostream>
+
+class AssetCache
+{
+public:
+	static AssetCache& get();
+
+	// Load on first request, otherwise return the cached handle. Returns nullptr if the file fails to load.
+	std::shared_ptr<sf::Texture> getTexture(const std::string& path);
+	std::shared_ptr<sf::Font> getFont(const std::string& path);
+	std::shared_ptr<sf::SoundBuffer> getSoundBuffer(const std::string& path);
+
+	// Return the cached texture without loading. nullptr if not cached.
+	std::shared_ptr<sf::Texture> findTexture(const std::string& path);
+	// Store a texture created elsewhere (e.g. uploaded from a background decode). Keeps the existing entry if there is one.
+	std::shared_ptr<sf::Texture> addTexture(const std::string& path, sf::Texture&& texture);
+
+	// Drop every asset only the cache is holding. Returns the number of entries removed.
+	int evictUnused();
+	// Drop every asset. SFML resources must not outlive main(), so call this before it returns, once everything
+	// holding a handle has been destroyed. Handles still held are reported.
+	void shutdown();
+
+	size_t getMemoryUsage() const;
+	// Prints every entry with its size and handle count, then the totals
+	void printReport(std::ostream& out = std::cout) const;
+
+	static std::string canonicalPath(const std::string& path);
+
+	// Assets are read from assets.pack when it exists and holds them, otherwise from loose files.
+	// The pack is read-only once open, so it may be used from any thread.
+	const AssetPack& getPack() const { return pack; }
+	// Load an sf::Image, sf::Font or sf::SoundBuffer from the pack, or from the loose file if it is not packed
+	template <typename T>
+	bool loadAsset(T& asset, const std::string& path) const;
+
+	// Decoded pixels for image files from earlier runs. getTexture reads from it and adds anything it had to decode.
+	TextureCache& getTextureCache() { return textureCache; }
+
+private:
+	AssetCache();
+	AssetCache(const AssetCache&) = delete;
+	AssetCache& operator=(const AssetCache&) = delete;
+
+	template <typename T>
+	struct Entry
+	{
+		std::shared_ptr<T> asset;
+		size_t bytes;
+	};
+
+	template <typename T>
+	static int evict(std::unordered_map<std::string, Entry<T>>& entries);
+	template <typename T>
+	static void report(std::ostream& out, const char* type, const std::unordered_map<std::string, Entry<T>>& entries, size_t& total);
+
+	size_t fileSize(const std::string& path) const;
+
+	std::unordered_map<std::string, Entry<sf::Texture>> textures;
+	std::unordered_map<std::string, Entry<sf::Font>> fonts;
+	std::unordered_map<std::string, Entry<sf::SoundBuffer>> soundBuffers;
+	AssetPack pack;
+	TextureCache textureCache;
+};
+
+template <typename T>
+bool AssetCache::loadAsset(T& asset, const std::string& path) const
+{
+	const char* data;
+	size_t size;
+	if (pack.find(path, data, size))
+	{
+		return asset.loadFromMemory(data, size);
+	}
+	return asset.loadFromFile(path);
+}
@@ -0,0 +1,212 @@
+#include "AssetPack.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	const uint32_t AssetPackMagic = 0x4B415041; // "APAK"
+	const uint32_t AssetPackVersion = 1;
+}
+
+AssetPack::AssetPack()
+{
+	modifiedTime = 0;
+}
+
+bool AssetPack::open(const std::string& packPath)
+{
+	close();
+	if (!file.open(packPath))
+	{
+		return false;
+	}
+
+	// Check the table of contents and every entry lie inside the file before trusting them
+	const char* data = file.getData();
+	size_t size = file.getSize();
+	const FileHeader* header = (const FileHeader*)data;
+	if (size < sizeof(FileHeader) || header->magic != AssetPackMagic || header->version != AssetPackVersion
+		|| sizeof(FileHeader) + (uint64_t)header->entryCount * sizeof(FileEntry) > header->stringDataOffset
+		|| header->stringDataOffset > size)
+	{
+		std::cerr << "Invalid asset pack: " << packPath << std::endl;
+		file.close();
+		return false;
+	}
+
+	const FileEntry* entries = (const FileEntry*)(data + sizeof(FileHeader));
+	for (uint32_t i = 0; i < header->entryCount; i++)
+	{
+		const FileEntry& entry = entries[i];
+		if (header->stringDataOffset + (uint64_t)entry.pathOffset + entry.pathLength > size
+			|| entry.dataOffset + entry.size > size)
+		{
+			std::cerr << "Invalid asset pack entry " << i << " in " << packPath << std::endl;
+			continue;
+		}
+		index[std::string(data + header->stringDataOffset + entry.pathOffset, entry.pathLength)] = &entry;
+	}
+	std::error_code error;
+	modifiedTime = (int64_t)fs::last_write_time(packPath, error).time_since_epoch().count();
+	std::cout << "Opened asset pack " << packPath << " with " << index.size() << " assets" << std::endl;
+	return true;
+}
+
+void AssetPack::close()
+{
+	index.clear();
+	file.close();
+	modifiedTime = 0;
+}
+
+std::string AssetPack::normalise(const std::string& path)
+{
+	std::string generic = path;
+	std::replace(generic.begin(), generic.end(), '\\', '/');
+	std::string normal = fs::path(generic).lexically_normal().generic_string();
+	if (normal.compare(0, 2, "./") == 0)
+	{
+		normal.erase(0, 2);
+	}
+	return normal;
+}
+
+bool AssetPack::contains(const std::string& path) const
+{
+	return !index.empty() && index.count(normalise(path)) > 0 && !isOverridden(path);
+}
+
+bool AssetPack::find(const std::string& path, const char*& data, size_t& size) const
+{
+	if (index.empty()) return false;
+	auto it = index.find(normalise(path));
+	if (it == index.end() || isOverridden(path)) return false;
+
+	data = file.getData() + it->second->dataOffset;
+	size = (size_t)it->second->size;
+	return true;
+}
+
+// A loose file written since the pack was built, e.g. a level saved by the editor, is newer than its packed copy
+bool AssetPack::isOverridden(const std::string& path) const
+{
+	std::error_code error;
+	int64_t looseTime = (int64_t)fs::last_write_time(path, error).time_since_epoch().count();
+	return !error && looseTime > modifiedTime;
+}
+
+bool AssetPack::openStream(const std::string& path, sf::MemoryInputStream& stream) const
+{
+	const char* data;
+	size_t size;
+	if (!find(path, data, size)) return false;
+	stream.open(data, size);
+	return true;
+}
+
+std::vector<std::string> AssetPack::list(const std::string& directory) const
+{
+	std::string prefix = normalise(directory);
+	if (!prefix.empty() && prefix.back() != '/') prefix += '/';
+
+	std::vector<std::string> paths;
+	for (auto& entry : index)
+	{
+		const std::string& path = entry.first;
+		if (path.compare(0, prefix.size(), prefix) == 0 && path.find('/', prefix.size()) == std::string::npos)
+		{
+			paths.push_back(path);
+		}
+	}
+	std::sort(paths.begin(), paths.end());
+	return paths;
+}
+
+// Layout: header, entries, path strings, then file contents aligned to 16 bytes
+bool AssetPack::build(const std::string& packPath, const std::vector<std::string>& sources)
+{
+	std::vector<std::string> files;
+	for (const std::string& source : sources)
+	{
+		std::error_code error;
+		if (fs::is_directory(source, error))
+		{
+			for (const auto& entry : fs::recursive_directory_iterator(source, error))
+			{
+				if (entry.is_regular_file()) files.push_back(normalise(entry.path().generic_string()));
+			}
+		}
+		else if (fs::is_regular_file(source, error))
+		{
+			files.push_back(normalise(source));
+		}
+		else
+		{
+			std::cerr << "Asset pack source not found: " << source << std::endl;
+		}
+	}
+	std::sort(files.begin(), files.end());
+	files.erase(std::unique(files.begin(), files.end()), files.end());
+
+	FileHeader header;
+	header.magic = AssetPackMagic;
+	header.version = AssetPackVersion;
+	header.entryCount = (uint32_t)files.size();
+	header.stringDataOffset = (uint32_t)(sizeof(FileHeader) + files.size() * sizeof(FileEntry));
+
+	std::string strings;
+	std::vector<FileEntry> entries;
+	for (const std::string& path : files)
+	{
+		FileEntry entry;
+		entry.pathOffset = (uint32_t)strings.size();
+		entry.pathLength = (uint32_t)path.size();
+		entry.dataOffset = 0;
+		std::error_code error;
+		entry.size = fs::file_size(path, error);
+		strings += path;
+		entries.push_back(entry);
+	}
+	uint64_t offset = header.stringDataOffset + strings.size();
+	for (FileEntry& entry : entries)
+	{
+		offset = (offset + 15) & ~(uint64_t)15;
+		entry.dataOffset = offset;
+		offset += entry.size;
+	}
+
+	std::ofstream out(packPath, std::ios::binary | std::ios::trunc);
+	if (!out.is_open())
+	{
+		std::cerr << "Failed to write asset pack " << packPath << std::endl;
+		return false;
+	}
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)entries.data(), entries.size() * sizeof(FileEntry));
+	out.write(strings.data(), strings.size());
+
+	uint64_t written = header.stringDataOffset + strings.size();
+	const char padding[16] = {};
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		out.write(padding, entries[i].dataOffset - written);
+		std::ifstream in(files[i], std::ios::binary);
+		if (entries[i].size > 0 && !(out << in.rdbuf()))
+		{
+			std::cerr << "Failed to pack " << files[i] << std::endl;
+			return false;
+		}
+		written = entries[i].dataOffset + entries[i].size;
+	}
+	if (!out.good())
+	{
+		std::cerr << "Failed to write asset pack " << packPath << std::endl;
+		return false;
+	}
+	std::cout << "Packed " << files.size() << " files into " << packPath << " (" << written / 1024 << " KB)" << std::endl;
+	return true;
+}
@@ -0,0 +1,67 @@
+// Asset Pack Class
+// Reads assets out of a single pack file instead of many loose files.
+// The pack is a table of contents followed by every asset stored back to back. It is memory mapped once,
+// and each asset is handed out as a stream or pointer straight into the mapping, so nothing is copied.
+// Paths are looked up as given in code ("gfx/Mario.png"); files missing from the pack fall back to loose files,
+// and so do packed files whose loose copy has been changed since the pack was built.
+// The pack is read-only once open, so lookups are safe from any thread.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+class AssetPack
+{
+public:
+	AssetPack();
+
+	bool open(const std::string& packPath);
+	void close();
+	bool isOpen() const { return file.isOpen(); }
+
+	// False for assets whose loose file is newer than the pack, so the loose file is used instead
+	bool contains(const std::string& path) const;
+	// Pointer and size of the asset inside the mapping. Valid until the pack is closed.
+	bool find(const std::string& path, const char*& data, size_t& size) const;
+	// Point a memory stream at the asset, for the SFML loadFromStream calls
+	bool openStream(const std::string& path, sf::MemoryInputStream& stream) const;
+	// Paths of the packed files directly inside a directory, e.g. list("gfx")
+	std::vector<std::string> list(const std::string& directory) const;
+
+	int getAssetCount() const { return (int)index.size(); }
+	// Write time of the pack file, which stands in for the write time of everything packed in it
+	int64_t getModifiedTime() const { return modifiedTime; }
+
+	// Pack every file under the given directories (and any single files) into packPath
+	static bool build(const std::string& packPath, const std::vector<std::string>& sources);
+
+	// Pack paths use forward slashes with no "./" or ".." parts
+	static std::string normalise(const std::string& path);
+
+private:
+	struct FileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t stringDataOffset;
+	};
+
+	struct FileEntry
+	{
+		uint32_t pathOffset;
+		uint32_t pathLength;
+		uint64_t dataOffset;
+		uint64_t size;
+	};
+
+	bool isOverridden(const std::string& path) const;
+
+	MappedFile file;
+	std::unordered_map<std::string, const FileEntry*> index;
+	int64_t modifiedTime;
+};
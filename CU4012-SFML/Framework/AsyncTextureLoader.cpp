@@ -0,0 +1,88 @@
+#include "AsyncTextureLoader.h"
+#include "AssetCache.h"
+
+AsyncTextureLoader::AsyncTextureLoader(unsigned int threadCount)
+{
+	pending = 0;
+	stopping = false;
+
+	if (threadCount == 0)
+	{
+		threadCount = std::thread::hardware_concurrency();
+		if (threadCount == 0) threadCount = 2;
+	}
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		workers.emplace_back(&AsyncTextureLoader::workerLoop, this);
+	}
+}
+
+AsyncTextureLoader::~AsyncTextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+		jobs.clear();
+	}
+	jobAvailable.notify_all();
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void AsyncTextureLoader::request(const std::string& name, const std::string& path)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back({ name, path });
+		pending++;
+	}
+	jobAvailable.notify_one();
+}
+
+bool AsyncTextureLoader::poll(DecodedImage& out)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (decoded.empty())
+	{
+		return false;
+	}
+	out = std::move(decoded.front());
+	decoded.pop_front();
+	pending--;
+	return true;
+}
+
+int AsyncTextureLoader::getPendingCount()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return pending;
+}
+
+// Each worker takes one file at a time and decodes it outside the lock
+void AsyncTextureLoader::workerLoop()
+{
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+			if (stopping)
+			{
+				return;
+			}
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+
+		DecodedImage result;
+		result.name = job.name;
+		result.path = job.path;
+		result.loaded = AssetCache::get().loadAsset(result.image, job.path);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		decoded.push_back(std::move(result));
+	}
+}
@@ -0,0 +1,55 @@
+// Async Texture Loader Class
+// Decodes image files into sf::Image on a pool of worker threads.
+// Decoded images are collected on the main thread, which is the only thread that may create textures.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class AsyncTextureLoader
+{
+public:
+	struct DecodedImage
+	{
+		std::string name;
+		std::string path;
+		sf::Image image;
+		bool loaded = false;
+	};
+
+	// threadCount of 0 uses one worker per hardware thread
+	AsyncTextureLoader(unsigned int threadCount = 0);
+	~AsyncTextureLoader();
+
+	// Queue a file to be decoded in the background
+	void request(const std::string& name, const std::string& path);
+
+	// Take the next decoded image, if any. Main thread only.
+	bool poll(DecodedImage& out);
+
+	// Requests not yet handed back through poll
+	int getPendingCount();
+
+private:
+	void workerLoop();
+
+	struct Job
+	{
+		std::string name;
+		std::string path;
+	};
+
+	std::vector<std::thread> workers;
+	std::deque<Job> jobs;
+	std::deque<DecodedImage> decoded;
+	int pending;
+	bool stopping;
+
+	std::mutex mutex;
+	std::condition_variable jobAvailable;
+};
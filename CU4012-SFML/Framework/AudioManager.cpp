@@ -1,11 +1,18 @@
 #include "AudioManager.h"
+#include "AssetCache.h"
+#include <algorithm>
+#include <cmath>
 
 // Some initial setup of music.
 // All music will loop and have half the normal volume (so background music is quieter).
-AudioManager::AudioManager()
+AudioManager::AudioManager(unsigned int voiceCount) : voices(voiceCount)
 {
-	music.setLoop(true);
-	music.setVolume(50);
+	musicPlayer.setLoop(true);
+	musicPlayer.setVolume(50);
+	playCount = 0;
+	reservedPcm = 0;
+	audibleRadius = 1000.f;
+	culledCount = 0;
 }
 
 AudioManager::~AudioManager()
@@ -13,86 +20,392 @@ AudioManager::~AudioManager()
 	// Stop all sounds and music
 	stopAllSounds();
 	stopAllMusic();
+	// Voices must let go of the buffers before the sounds that own them go
+	for (Voice& voice : voices)
+	{
+		voice.sound.resetBuffer();
+	}
 	// Clear all sound objects
 	sounds.clear();
 	// Clear all music objects
 	musics.clear();
+	soundIds.clear();
+	musicIds.clear();
 }
 
 // Given a filename and key a new SOUND object is added to the list. Loading the object into memory for playback
-void AudioManager::addSound(std::string filename, std::string lname)
+// A key that is already registered keeps its original sound.
+SoundId AudioManager::addSound(const std::string& filename, const std::string& lname, int maxInstances, int priority)
 {
-	
-	sounds.push_back(s);
-	sounds.back().loadSound(filename, lname);
-	
+	SoundId existing = findSound(lname);
+	if (existing != InvalidAudioId)
+	{
+		return existing;
+	}
+
+	size_t pcmBytes = 0;
+	AudioLoadMode mode = chooseLoadMode(filename, pcmBytes);
+
+	SoundId id = (SoundId)sounds.size();
+	sounds.emplace_back();
+	sounds.back().loadSound(filename, lname, mode);
+	sounds.back().pcmBytes = pcmBytes;
+	sounds.back().maxInstances = maxInstances;
+	sounds.back().priority = priority;
+	soundIds[lname] = id;
+	return id;
 }
 
-// Play back sound based on provided key.
-void AudioManager::playSoundbyName(std::string lname)
+// The same file under another name shares its buffer, so it takes the same mode and reserves nothing more
+AudioLoadMode AudioManager::chooseLoadMode(const std::string& filename, size_t& pcmBytes)
 {
-	for (int i = 0; i < sounds.size(); i++)
+	for (const SoundObject& object : sounds)
 	{
-		if (sounds[i].name == lname)
+		if (object.filename == filename)
 		{
-			sounds[i].sound.play();
-			//std::cout << lname << " " << i << std::endl;
-			return;
+			pcmBytes = object.pcmBytes;
+			return object.mode;
 		}
 	}
+
+	float duration = 0.f;
+	if (!probeSound(filename, duration, pcmBytes))
+	{
+		return AudioLoadMode::Preload; // Let the load report the error
+	}
+	if (duration >= loadPolicy.streamDuration || reservedPcm + pcmBytes > loadPolicy.memoryBudget)
+	{
+		return AudioLoadMode::Stream;
+	}
+	reservedPcm += pcmBytes;
+	return pcmBytes <= loadPolicy.preloadLimit ? AudioLoadMode::Preload : AudioLoadMode::Lazy;
 }
 
-// Stop all sounds. Possible that multiple sounds (not music) can be played simultaneously. This stops all sounds.
-void AudioManager::stopAllSounds()
+bool AudioManager::probeSound(const std::string& filename, float& duration, size_t& pcmBytes)
+{
+	sf::InputSoundFile file;
+	const char* data;
+	size_t size;
+	bool opened = AssetCache::get().getPack().find(filename, data, size)
+		? file.openFromMemory(data, size) : file.openFromFile(filename);
+	if (!opened)
+	{
+		return false;
+	}
+	duration = file.getDuration().asSeconds();
+	pcmBytes = (size_t)file.getSampleCount() * sizeof(sf::Int16);
+	return true;
+}
+
+SoundId AudioManager::findSound(const std::string& lname) const
+{
+	auto it = soundIds.find(lname);
+	return it != soundIds.end() ? it->second : InvalidAudioId;
+}
+
+// Play back sound based on provided id, on a voice from the pool.
+void AudioManager::playSound(SoundId id)
+{
+	startSound(id, nullptr);
+}
+
+// Culling happens here, before a voice is looked for, so distant sounds never steal one
+void AudioManager::playSoundAt(SoundId id, const sf::Vector2f& position)
+{
+	float gain, pan;
+	if (!spatialise(position, gain, pan))
+	{
+		culledCount++;
+		return;
+	}
+	startSound(id, &position);
+}
+
+// Global sounds (no position) play centred at the sound's own volume
+void AudioManager::startSound(SoundId id, const sf::Vector2f* position)
+{
+	if (id >= sounds.size())
+	{
+		return;
+	}
+
+	SoundObject& object = sounds[id];
+	if (object.mode == AudioLoadMode::Stream)
+	{
+		playStream(object, position);
+		return;
+	}
+	object.makeResident();
+	if (object.sound.getBuffer() == nullptr)
+	{
+		return;
+	}
+	Voice* voice = findVoice(id, object.maxInstances, object.priority);
+	if (voice == nullptr)
+	{
+		return;
+	}
+
+	voice->sound.stop();
+	if (voice->sound.getBuffer() != object.sound.getBuffer())
+	{
+		voice->sound.setBuffer(*object.sound.getBuffer());
+	}
+	voice->baseVolume = object.sound.getVolume();
+	voice->positional = position != nullptr;
+	float gain = 1.f, pan = 0.f;
+	if (position != nullptr)
+	{
+		voice->position = *position;
+		spatialise(*position, gain, pan);
+	}
+	applySpatial(voice->sound, voice->baseVolume, gain, pan);
+	voice->sound.setPitch(object.sound.getPitch());
+	voice->sound.setLoop(object.sound.getLoop());
+	voice->id = id;
+	voice->priority = object.priority;
+	voice->started = ++playCount;
+	voice->sound.play();
+}
+
+// Streamed sounds have a single stream each, so playing one again restarts it
+void AudioManager::playStream(SoundObject& object, const sf::Vector2f* position)
+{
+	if (!object.stream)
+	{
+		return;
+	}
+	float gain = 1.f, pan = 0.f;
+	if (position != nullptr)
+	{
+		spatialise(*position, gain, pan);
+	}
+	object.stream->stop();
+	applySpatial(*object.stream, object.sound.getVolume(), gain, pan);
+	object.stream->setPitch(object.sound.getPitch());
+	object.stream->setLoop(object.sound.getLoop());
+	object.stream->play();
+}
+
+bool AudioManager::spatialise(const sf::Vector2f& position, float& gain, float& pan) const
+{
+	sf::Vector2f offset = position - listener;
+	float distance = std::sqrt(offset.x * offset.x + offset.y * offset.y);
+	if (distance >= audibleRadius)
+	{
+		gain = 0.f;
+		pan = 0.f;
+		return false;
+	}
+	float falloff = 1.f - distance / audibleRadius;
+	gain = falloff * falloff;
+	pan = std::max(-1.f, std::min(1.f, offset.x / audibleRadius));
+	return true;
+}
+
+// Panning uses OpenAL positioning relative to the listener, one unit away so distance attenuation has no effect.
+// OpenAL only positions mono sounds; stereo ones are still attenuated but stay centred.
+void AudioManager::applySpatial(sf::SoundSource& source, float baseVolume, float gain, float pan)
+{
+	source.setVolume(baseVolume * gain);
+	source.setRelativeToListener(true);
+	source.setAttenuation(0.f);
+	if (pan == 0.f)
+	{
+		source.setPosition(0.f, 0.f, 0.f);
+	}
+	else
+	{
+		source.setPosition(pan, 0.f, -std::sqrt(1.f - pan * pan));
+	}
+}
+
+// One pass over the pool. A sound at its instance limit restarts its own oldest instance, otherwise a free voice
+// is used, otherwise the lowest priority voice no more important than the new sound (quietest, then oldest) is stolen.
+AudioManager::Voice* AudioManager::findVoice(SoundId id, int maxInstances, int priority)
 {
-	for (int i = 0; i < sounds.size(); i++)
+	Voice* free = nullptr;
+	Voice* oldestInstance = nullptr;
+	Voice* victim = nullptr;
+	int instances = 0;
+
+	for (Voice& voice : voices)
+	{
+		if (voice.sound.getStatus() == sf::Sound::Stopped)
+		{
+			if (free == nullptr) free = &voice;
+			continue;
+		}
+		if (voice.id == id)
+		{
+			instances++;
+			if (oldestInstance == nullptr || voice.started < oldestInstance->started) oldestInstance = &voice;
+		}
+		if (voice.priority > priority)
+		{
+			continue;
+		}
+		if (victim == nullptr || voice.priority < victim->priority
+			|| (voice.priority == victim->priority && (voice.sound.getVolume() < victim->sound.getVolume()
+				|| (voice.sound.getVolume() == victim->sound.getVolume() && voice.started < victim->started))))
+		{
+			victim = &voice;
+		}
+	}
+
+	if (instances >= maxInstances && oldestInstance != nullptr)
 	{
-		sounds[i].sound.stop();
+		return oldestInstance;
 	}
+	return free != nullptr ? free : victim;
 }
 
-sf::Sound* AudioManager::getSound(std::string lname)
+size_t AudioManager::getSoundMemoryUsage() const
 {
-	for (int i = 0; i < sounds.size(); i++)
+	std::vector<const sf::SoundBuffer*> counted;
+	size_t bytes = 0;
+	for (const SoundObject& object : sounds)
 	{
-		if (sounds[i].name == lname)
+		const sf::SoundBuffer* buffer = object.sound.getBuffer();
+		if (buffer == nullptr || std::find(counted.begin(), counted.end(), buffer) != counted.end())
 		{
-			return &sounds[i].sound;
+			continue;
 		}
+		counted.push_back(buffer);
+		bytes += (size_t)buffer->getSampleCount() * sizeof(sf::Int16);
+	}
+	return bytes;
+}
+
+void AudioManager::printReport(std::ostream& out) const
+{
+	const char* modeNames[] = { "preload", "lazy", "stream" };
+	for (const SoundObject& object : sounds)
+	{
+		out << "  " << object.name << " (" << object.filename << "): " << modeNames[(int)object.mode] << ", "
+			<< object.pcmBytes / 1024 << " KB PCM" << (object.isResident() ? ", resident" : "") << std::endl;
+	}
+	out << "Audio: " << getSoundMemoryUsage() / 1024 << " KB resident, " << reservedPcm / 1024 << " KB reserved of "
+		<< loadPolicy.memoryBudget / 1024 << " KB budget" << std::endl;
+}
+
+int AudioManager::getActiveVoiceCount() const
+{
+	int active = 0;
+	for (const Voice& voice : voices)
+	{
+		if (voice.sound.getStatus() != sf::Sound::Stopped) active++;
+	}
+	return active;
+}
+
+// Play back sound based on provided key.
+void AudioManager::playSoundbyName(const std::string& lname)
+{
+	playSound(findSound(lname));
+}
+
+// Stop all sounds. Possible that multiple sounds (not music) can be played simultaneously. This stops all sounds.
+void AudioManager::stopAllSounds()
+{
+	for (Voice& voice : voices)
+	{
+		voice.sound.stop();
+	}
+	for (SoundObject& object : sounds)
+	{
+		if (object.stream) object.stream->stop();
 	}
-	return nullptr;
+}
+
+sf::Sound* AudioManager::getSound(SoundId id)
+{
+	return id < sounds.size() ? &sounds[id].sound : nullptr;
+}
+
+sf::Sound* AudioManager::getSound(const std::string& lname)
+{
+	return getSound(findSound(lname));
 }
 
 // Stores filename and key of music file. These are not loaded into memory but streamed when required.
-void AudioManager::addMusic(std::string filename, std::string lname)
+MusicId AudioManager::addMusic(const std::string& filename, const std::string& lname)
 {
+	MusicId existing = findMusic(lname);
+	if (existing != InvalidAudioId)
+	{
+		return existing;
+	}
+
+	MusicId id = (MusicId)musics.size();
 	MusicObject mu;
 	musics.push_back(mu);
 	musics.back().setMusic(filename, lname);
+	musicIds[lname] = id;
+	return id;
+}
+
+MusicId AudioManager::findMusic(const std::string& lname) const
+{
+	auto it = musicIds.find(lname);
+	return it != musicIds.end() ? it->second : InvalidAudioId;
+}
+
+// Starts streaming music file based on id provided.
+void AudioManager::playMusic(MusicId id, float fadeTime)
+{
+	if (id < musics.size())
+	{
+		musicPlayer.crossfadeTo(musics[id].filename, fadeTime);
+	}
 }
 
 // Starts streaming music file based on key provided.
-void AudioManager::playMusicbyName(std::string lname)
+void AudioManager::playMusicbyName(const std::string& lname, float fadeTime)
+{
+	playMusic(findMusic(lname), fadeTime);
+}
+
+void AudioManager::prefetchMusic(MusicId id)
+{
+	if (id < musics.size())
+	{
+		musicPlayer.prefetch(musics[id].filename);
+	}
+}
+
+// Positional voices follow the listener. Out of earshot, one-shot sounds are stopped to free their voice; looping ones
+// are kept at zero volume so they come back when the listener returns.
+void AudioManager::update(float dt)
 {
-	for (int i = 0; i < musics.size(); i++)
+	for (Voice& voice : voices)
 	{
-		if (musics[i].name == lname)
+		if (!voice.positional || voice.sound.getStatus() == sf::Sound::Stopped)
+		{
+			continue;
+		}
+		float gain, pan;
+		if (!spatialise(voice.position, gain, pan) && !voice.sound.getLoop())
 		{
-			music.openFromFile(musics[i].filename);
-			music.play();
-			return;
+			// The listener moved away; free the voice rather than mix silence. Loops are kept to fade back in.
+			voice.sound.stop();
+			voice.positional = false;
+			culledCount++;
+			continue;
 		}
+		applySpatial(voice.sound, voice.baseVolume, gain, pan);
 	}
+	musicPlayer.update(dt);
 }
 
 // Stops music.
 void AudioManager::stopAllMusic()
 {
-	music.stop();
+	musicPlayer.stop();
 }
 
 // Returns pointer to music object.
 sf::Music* AudioManager::getMusic()
 {
-	return &music;
+	return musicPlayer.getCurrent();
 }
\ No newline at end of file
@@ -1,46 +1,143 @@
 // Audio Manager Class
 // Manages storage and playback of multiple sound and music objects.
 // Maintains lists of Sound and Music for playback in game
+// Sounds play on a fixed pool of voices shared by every sound, so the same sound can overlap itself.
+// When the pool is full a new sound steals the lowest priority voice, then the quietest, then the oldest.
+// Each sound is preloaded, decoded on first use or streamed, as decided by the AudioLoadPolicy when it is added.
+// Sounds played at a world position are culled beyond the audible radius of the listener before a voice is taken,
+// and attenuated and panned by their offset from it otherwise. Ones the listener moves away from are stopped by update().
 
 #pragma once
 
 #include "SoundObject.h"
 #include "MusicObject.h"
+#include "MusicPlayer.h"
 #include "SFML\Audio.hpp"
 #include<iostream>
+#include <unordered_map>
+
+// Index of a registered sound or music. Look it up once by name, then play by id with no string work.
+typedef unsigned short SoundId;
+typedef unsigned short MusicId;
+const unsigned short InvalidAudioId = 0xFFFF;
+
+// Decides how each sound is held. Sizes are decoded 16-bit PCM, read from the file header without decoding.
+// Preloaded and lazy sounds both count against the budget when they are added, so resident PCM can never exceed it;
+// sounds that would not fit are streamed instead.
+struct AudioLoadPolicy
+{
+	size_t memoryBudget = 32 * 1024 * 1024;	// Ceiling for resident PCM across all sounds
+	size_t preloadLimit = 512 * 1024;		// Sounds up to this size are decoded when added
+	float streamDuration = 10.f;			// Sounds this long or longer are always streamed
+};
 
 class AudioManager
 {
 public:
-	AudioManager();
+	AudioManager(unsigned int voiceCount = 32);
 	~AudioManager();
 	
-	// Add sound object, provide file path and key string
-	void addSound(std::string filename, std::string lname);
+	// Add sound object, provide file path and key string. Returns the sound's id.
+	// At most maxInstances copies play at once; a further play restarts the oldest copy.
+	// Higher priority sounds may steal voices from lower priority ones when the pool is full.
+	SoundId addSound(const std::string& filename, const std::string& lname, int maxInstances = 4, int priority = 0);
+	// Id of the sound registered under the key, or InvalidAudioId
+	SoundId findSound(const std::string& lname) const;
+	// Plays sound by id (if sound exists).
+	void playSound(SoundId id);
 	// Plays sound based on key string provided (if sound exists).
-	void playSoundbyName(std::string lname);
+	void playSoundbyName(const std::string& lname);
+	// Plays sound at a world position. Out of earshot it is dropped without using a voice.
+	void playSoundAt(SoundId id, const sf::Vector2f& position);
+
+	// The listener should follow the view centre. Positional voices are re-attenuated as it moves.
+	void setListenerPosition(const sf::Vector2f& position) { listener = position; }
+	const sf::Vector2f& getListenerPosition() const { return listener; }
+	// Distance in world units at which positional sounds fade to silence
+	void setAudibleRadius(float radius) { audibleRadius = radius; }
+	// Positional plays dropped, or stopped early, for being out of range, since the start
+	int getCulledCount() const { return culledCount; }
+	// Must be set before sounds are added
+	void setLoadPolicy(const AudioLoadPolicy& policy) { loadPolicy = policy; }
 	// Stops playing all sounds (multiple sfx's can be played simultaneously
 	void stopAllSounds();
-	// Returns the sound object (based on key string). Can be useful for tracking play state, looping, volume etc.
-	sf::Sound* getSound(std::string lname);
+	// Returns the sound object (by id or key string). Its volume, pitch and looping are copied to every voice it plays on.
+	sf::Sound* getSound(SoundId id);
+	sf::Sound* getSound(const std::string& lname);
+
+	// Size of the voice pool, and the voices currently playing
+	int getVoiceCount() const { return (int)voices.size(); }
+	int getActiveVoiceCount() const;
+	// Bytes of decoded samples held by the registered sounds. Sounds sharing a file are counted once.
+	size_t getSoundMemoryUsage() const;
+	// Resident PCM the policy has set aside for preloaded and lazy sounds
+	size_t getReservedMemory() const { return reservedPcm; }
+	// Prints every sound with its load mode and size, then resident memory against the budget
+	void printReport(std::ostream& out = std::cout) const;
 
-	// Add music object, provide file path and key string.
-	void addMusic(std::string filename, std::string lname);
+	// Add music object, provide file path and key string. Returns the music's id.
+	MusicId addMusic(const std::string& filename, const std::string& lname);
+	// Id of the music registered under the key, or InvalidAudioId
+	MusicId findMusic(const std::string& lname) const;
+	// Play/stream music by id (if music exists), crossfading from the current track over fadeTime seconds.
+	// The track is opened in the background, so it starts a frame or more later unless it was prefetched.
+	void playMusic(MusicId id, float fadeTime = 1.f);
 	// Play/stream music based on key string provided (if music exists).
-	void playMusicbyName(std::string lname);
+	void playMusicbyName(const std::string& lname, float fadeTime = 1.f);
+	// Open a track in the background ahead of switching to it
+	void prefetchMusic(MusicId id);
 	// Stop music.
 	void stopAllMusic();
-	// Return pointer to music object. Useful for controlling looping, play state, volume etc.
+	// Return pointer to the current music object. Useful for checking play state etc. Volume and looping are set by the player.
 	sf::Music* getMusic();
 
+	// Moves music fades and background opens along, and re-attenuates positional voices against the listener,
+	// stopping one-shot sounds that are now out of range. Call once per frame.
+	void update(float dt);
+
 private:
-	// List of sounds
+	struct Voice
+	{
+		sf::Sound sound;
+		SoundId id = InvalidAudioId;
+		int priority = 0;
+		unsigned int started = 0; // Value of playCount when the voice was started, for finding the oldest
+		bool positional = false;
+		sf::Vector2f position;
+		float baseVolume = 100.f; // Volume before attenuation
+	};
+
+	void startSound(SoundId id, const sf::Vector2f* position);
+	// Gain (0 to 1) and pan (-1 left to 1 right) of a world position. Returns false if it is out of earshot.
+	bool spatialise(const sf::Vector2f& position, float& gain, float& pan) const;
+	static void applySpatial(sf::SoundSource& source, float baseVolume, float gain, float pan);
+
+	// Reads the duration and decoded size from the file header. Returns false if the file cannot be opened.
+	static bool probeSound(const std::string& filename, float& duration, size_t& pcmBytes);
+	AudioLoadMode chooseLoadMode(const std::string& filename, size_t& pcmBytes);
+	void playStream(SoundObject& object, const sf::Vector2f* position);
+
+	// Voice to play a new instance of the sound on, or nullptr if every voice is busy with something more important
+	Voice* findVoice(SoundId id, int maxInstances, int priority);
+
+	// List of sounds, indexed by SoundId
 	std::vector<SoundObject> sounds;
-	// List of Musics
+	// List of Musics, indexed by MusicId
 	std::vector<MusicObject> musics;
-	// Single Music object as the stream cannot be copied.
-	sf::Music music;
-	// Re-useable sound object
-	SoundObject s;
+	// Key to id lookups
+	std::unordered_map<std::string, SoundId> soundIds;
+	std::unordered_map<std::string, MusicId> musicIds;
+	// Music streams, two so that tracks can crossfade
+	MusicPlayer musicPlayer;
+	// Fixed pool of voices, created up front and reused
+	std::vector<Voice> voices;
+	unsigned int playCount;
+
+	AudioLoadPolicy loadPolicy;
+	size_t reservedPcm;
+
+	sf::Vector2f listener;
+	float audibleRadius;
+	int culledCount;
 };
 
@@ -4,6 +4,7 @@ BaseLevel::BaseLevel()
 {
 	window = nullptr;
 	input = nullptr;
+	renderer = nullptr;
 }
 
 BaseLevel::~BaseLevel()
@@ -6,6 +6,7 @@
 #include "TileManager.h"
 #include "AudioManager.h"
 #include "World.h"
+#include "RenderBackend.h"
 #include <string>
 #include <iostream>
 
@@ -19,6 +20,9 @@ public:
 	virtual void update(float dt) = 0;
 	virtual void render() = 0;
 
+	// Everything the level renders goes through this backend
+	void setRenderer(RenderBackend* r) { renderer = r; }
+
 protected:
 	// Default variables for level class.
 	sf::RenderWindow* window;
@@ -28,5 +32,6 @@ protected:
 	sf::View* view;
 	TileManager* tileManager;
 	AudioManager* audioManager;
+	RenderBackend* renderer;
 };
 
@@ -0,0 +1,85 @@
+#include "DebugDraw.h"
+
+DebugDraw::DebugDraw()
+{
+	enabled = false;
+}
+
+void DebugDraw::setEnabled(bool e)
+{
+	enabled = e;
+	if (!enabled)
+	{
+		clear();
+	}
+}
+
+void DebugDraw::addLine(sf::Vector2f a, sf::Vector2f b, sf::Color color)
+{
+	if (!enabled) return;
+
+	lines.push_back(sf::Vertex(a, color));
+	lines.push_back(sf::Vertex(b, color));
+}
+
+// Four lines around the edge of the box, or four quads just outside it.
+void DebugDraw::addBox(const sf::FloatRect& box, sf::Color color, float thickness)
+{
+	if (!enabled) return;
+
+	if (thickness > 0.f)
+	{
+		float t = thickness;
+		addQuad(sf::FloatRect(box.left - t, box.top - t, box.width + t * 2.f, t), color);
+		addQuad(sf::FloatRect(box.left - t, box.top + box.height, box.width + t * 2.f, t), color);
+		addQuad(sf::FloatRect(box.left - t, box.top, t, box.height), color);
+		addQuad(sf::FloatRect(box.left + box.width, box.top, t, box.height), color);
+		return;
+	}
+
+	sf::Vector2f topLeft(box.left, box.top);
+	sf::Vector2f topRight(box.left + box.width, box.top);
+	sf::Vector2f bottomRight(box.left + box.width, box.top + box.height);
+	sf::Vector2f bottomLeft(box.left, box.top + box.height);
+
+	addLine(topLeft, topRight, color);
+	addLine(topRight, bottomRight, color);
+	addLine(bottomRight, bottomLeft, color);
+	addLine(bottomLeft, topLeft, color);
+}
+
+void DebugDraw::addQuad(const sf::FloatRect& rect, sf::Color color)
+{
+	sf::Vector2f topLeft(rect.left, rect.top);
+	sf::Vector2f topRight(rect.left + rect.width, rect.top);
+	sf::Vector2f bottomRight(rect.left + rect.width, rect.top + rect.height);
+	sf::Vector2f bottomLeft(rect.left, rect.top + rect.height);
+
+	triangles.push_back(sf::Vertex(topLeft, color));
+	triangles.push_back(sf::Vertex(topRight, color));
+	triangles.push_back(sf::Vertex(bottomRight, color));
+	triangles.push_back(sf::Vertex(topLeft, color));
+	triangles.push_back(sf::Vertex(bottomRight, color));
+	triangles.push_back(sf::Vertex(bottomLeft, color));
+}
+
+void DebugDraw::addPoint(sf::Vector2f point, sf::Color color, float size)
+{
+	if (!enabled) return;
+
+	addLine(sf::Vector2f(point.x - size, point.y - size), sf::Vector2f(point.x + size, point.y + size), color);
+	addLine(sf::Vector2f(point.x - size, point.y + size), sf::Vector2f(point.x + size, point.y - size), color);
+}
+
+void DebugDraw::render(RenderBackend& target)
+{
+	if (enabled && !triangles.empty())
+	{
+		target.draw(&triangles[0], triangles.size(), sf::Triangles);
+	}
+	if (enabled && !lines.empty())
+	{
+		target.draw(&lines[0], lines.size(), sf::Lines);
+	}
+	clear();
+}
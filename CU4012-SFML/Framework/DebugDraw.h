@@ -0,0 +1,38 @@
+// Debug Draw Class
+// Collects debug shapes (boxes, lines and contact points) during a frame into a single line list, plus a triangle
+// list for boxes with a thick outline. Each list is drawn with one draw call. While disabled, nothing is collected or drawn.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include "RenderBackend.h"
+#include <vector>
+
+class DebugDraw
+{
+public:
+	DebugDraw();
+
+	void setEnabled(bool e);
+	bool isEnabled() const { return enabled; }
+
+	// Queue shapes for this frame. These return immediately when debug drawing is disabled.
+	void addLine(sf::Vector2f a, sf::Vector2f b, sf::Color color);
+	// A thickness above zero draws the outline as quads of that width around the outside, like an sf::Shape outline
+	void addBox(const sf::FloatRect& box, sf::Color color, float thickness = 0.f);
+	// Contact points are drawn as a small cross centred on the point.
+	void addPoint(sf::Vector2f point, sf::Color color, float size = 4.f);
+
+	// Draw everything queued this frame in a single call, then clear the list.
+	void render(RenderBackend& target);
+	// Drop everything queued this frame without drawing it.
+	void clear() { lines.clear(); triangles.clear(); }
+
+private:
+	bool enabled;
+	// Line list, two vertices per line. Cleared each frame but its memory is reused.
+	std::vector<sf::Vertex> lines;
+	// Thick outlines, six vertices per edge
+	std::vector<sf::Vertex> triangles;
+
+	void addQuad(const sf::FloatRect& rect, sf::Color color);
+};
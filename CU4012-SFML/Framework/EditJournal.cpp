@@ -0,0 +1,440 @@
+#include "EditJournal.h"
+#include "MappedFile.h"
+#include <filesystem>
+#include <sstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+EditJournal::EditJournal()
+{
+	baseHash = 0;
+	recordCount = 0;
+	recoveryNeeded = false;
+	compactDone = false;
+	compactSucceeded = false;
+	compactHash = 0;
+}
+
+EditJournal::~EditJournal()
+{
+	wait();
+	close();
+}
+
+// Works out which journals still apply to the level file on disk:
+//   .journal not chained      applies if its base hash matches the level file
+//   .journal chained          applies after .journal.old if the compaction that rotated it never finished,
+//                             or directly if it finished but the new base line was not written yet
+//   .journal.old on its own   applies if it matches the level file (interrupted straight after rotating)
+// Anything else no longer matches the level file and is set aside rather than replayed onto the wrong tiles.
+bool EditJournal::open(const std::string& path)
+{
+	wait();
+	close();
+	levelPath = path;
+	journalPath = levelPath + ".journal";
+	oldJournalPath = journalPath + ".old";
+	baseHash = hashFile(levelPath);
+
+	JournalFile old, current;
+	readJournal(oldJournalPath, old);
+	readJournal(journalPath, current);
+
+	bool useOld = false;
+	bool useJournal = false;
+	bool rewriteBase = false;
+	bool reject = false;
+	if (current.exists)
+	{
+		if (!current.hasBase)
+		{
+			reject = true;
+		}
+		else if (current.chained)
+		{
+			if (old.exists && old.hasBase && old.baseHash == current.baseHash)
+			{
+				useOld = (old.baseHash == baseHash);
+				useJournal = true;
+				rewriteBase = !useOld;
+			}
+			else
+			{
+				reject = true;
+			}
+		}
+		else if (current.baseHash == baseHash)
+		{
+			useJournal = true;
+		}
+		else
+		{
+			reject = true;
+		}
+	}
+	else if (old.exists && old.hasBase && old.baseHash == baseHash)
+	{
+		useOld = true;
+	}
+
+	std::error_code error;
+	if (reject)
+	{
+		std::string rejectedPath = journalPath + ".rejected";
+		std::cerr << "Edit journal does not match " << levelPath << ", moved to " << rejectedPath << std::endl;
+		fs::remove(rejectedPath, error);
+		fs::rename(journalPath, rejectedPath, error);
+	}
+	if (old.exists && !useOld)
+	{
+		fs::remove(oldJournalPath, error);
+	}
+
+	oldRecords = useOld ? std::move(old.records) : std::vector<Record>();
+	journalRecords = useJournal ? std::move(current.records) : std::vector<Record>();
+	recoveryNeeded = useOld;
+	recordCount = (int)journalRecords.size();
+
+	if (useJournal)
+	{
+		journal.open(journalPath, std::ios::app);
+		if (rewriteBase) writeBaseLine(baseHash, false);
+	}
+	else
+	{
+		journal.open(journalPath, std::ios::trunc);
+		writeBaseLine(baseHash, useOld);
+	}
+
+	if (!journal.is_open())
+	{
+		std::cerr << "Failed to open edit journal " << journalPath << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void EditJournal::flush()
+{
+	if (journal.is_open())
+	{
+		journal.flush();
+	}
+}
+
+void EditJournal::close()
+{
+	if (journal.is_open())
+	{
+		journal.close();
+	}
+}
+
+bool EditJournal::replay(std::vector<LevelTile>& tiles, std::vector<unsigned int>& ids)
+{
+	std::vector<LevelTile> levelTiles;
+	if (fs::exists(levelPath))
+	{
+		bool loaded = LevelFile::isBinary(levelPath) ? LevelFile::readBinary(levelPath, levelTiles) : LevelFile::readCsv(levelPath, levelTiles);
+		if (!loaded) return false;
+	}
+	std::vector<bool> alive(levelTiles.size(), true);
+
+	// The old journal's ids were renumbered to tile order when it was rotated
+	if (!oldRecords.empty() || recoveryNeeded)
+	{
+		applyRecords(oldRecords, levelTiles, alive);
+		std::vector<LevelTile> renumbered;
+		for (size_t i = 0; i < levelTiles.size(); i++)
+		{
+			if (alive[i]) renumbered.push_back(std::move(levelTiles[i]));
+		}
+		levelTiles.swap(renumbered);
+		alive.assign(levelTiles.size(), true);
+	}
+	applyRecords(journalRecords, levelTiles, alive);
+
+	std::cout << "Replayed " << oldRecords.size() + journalRecords.size() << " journalled edits onto " << levelPath << std::endl;
+	oldRecords.clear();
+	journalRecords.clear();
+
+	for (size_t i = 0; i < levelTiles.size(); i++)
+	{
+		if (alive[i])
+		{
+			tiles.push_back(std::move(levelTiles[i]));
+			ids.push_back((unsigned int)i);
+		}
+	}
+	return true;
+}
+
+void EditJournal::recordAdd(unsigned int id, const LevelTile& tile)
+{
+	writeRecord('A', id, &tile);
+}
+
+void EditJournal::recordModify(unsigned int id, const LevelTile& tile)
+{
+	writeRecord('M', id, &tile);
+}
+
+void EditJournal::recordDelete(unsigned int id)
+{
+	writeRecord('D', id, nullptr);
+}
+
+// The current journal becomes .journal.old and a new chained journal takes its place, so editing carries on while
+// the level file is written. The old journal is only deleted once the new level file is in place.
+bool EditJournal::compact(std::vector<LevelTile> snapshot)
+{
+	if (isCompacting())
+	{
+		return false;
+	}
+
+	std::error_code error;
+	if (fs::exists(oldJournalPath, error))
+	{
+		// A previous compaction failed and its journal is still needed; finish the job here instead
+		return compactNow(snapshot);
+	}
+
+	journal.close();
+	fs::rename(journalPath, oldJournalPath, error);
+	if (error)
+	{
+		std::cerr << "Failed to rotate edit journal: " << error.message() << std::endl;
+		journal.open(journalPath, std::ios::app);
+		return false;
+	}
+	journal.open(journalPath, std::ios::trunc);
+	writeBaseLine(baseHash, true);
+	recordCount = 0;
+
+	compactDone = false;
+	compactClock.restart();
+	compactThread = std::thread([this, snapshot = std::move(snapshot)]()
+	{
+		std::string tempPath = levelPath + ".tmp";
+		compactSucceeded = writeLevel(tempPath, snapshot);
+		if (compactSucceeded)
+		{
+			compactHash = hashFile(tempPath);
+			std::error_code renameError;
+			fs::rename(tempPath, levelPath, renameError);
+			compactSucceeded = !renameError;
+		}
+		compactDone = true;
+	});
+	return true;
+}
+
+bool EditJournal::compactNow(const std::vector<LevelTile>& snapshot)
+{
+	wait();
+
+	std::string tempPath = levelPath + ".tmp";
+	std::error_code error;
+	if (!writeLevel(tempPath, snapshot))
+	{
+		return false;
+	}
+	uint64_t newHash = hashFile(tempPath);
+	fs::rename(tempPath, levelPath, error);
+	if (error)
+	{
+		std::cerr << "Failed to replace " << levelPath << ": " << error.message() << std::endl;
+		return false;
+	}
+	baseHash = newHash;
+
+	// Swap in a fresh journal before dropping the old one, so a crash in between leaves nothing that would replay twice
+	journal.close();
+	std::string tempJournalPath = journalPath + ".tmp";
+	{
+		std::ofstream fresh(tempJournalPath, std::ios::trunc);
+		fresh << "B," << std::hex << baseHash << std::dec << ",0\n";
+	}
+	fs::rename(tempJournalPath, journalPath, error);
+	fs::remove(oldJournalPath, error);
+	journal.open(journalPath, std::ios::app);
+
+	recordCount = 0;
+	recoveryNeeded = false;
+	std::cout << "Saved " << snapshot.size() << " tiles to " << levelPath << std::endl;
+	return true;
+}
+
+void EditJournal::update()
+{
+	if (!compactThread.joinable() || !compactDone) return;
+	compactThread.join();
+
+	if (compactSucceeded)
+	{
+		// Records in the current journal now apply to the new level file directly
+		baseHash = compactHash;
+		writeBaseLine(baseHash, false);
+		std::error_code error;
+		fs::remove(oldJournalPath, error);
+		std::cout << "Saved " << levelPath << " in the background in " << compactClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+	}
+	else
+	{
+		// The old journal stays in place, so nothing is lost; the next compaction retries
+		std::cerr << "Failed to save " << levelPath << ", edits are kept in the journal" << std::endl;
+	}
+}
+
+void EditJournal::wait()
+{
+	if (compactThread.joinable())
+	{
+		while (!compactDone) std::this_thread::yield();
+		update();
+	}
+}
+
+bool EditJournal::sameTile(const LevelTile& a, const LevelTile& b)
+{
+	return a.position == b.position && a.size == b.size
+		&& a.trigger == b.trigger && a.isStatic == b.isStatic && a.massless == b.massless && a.tile == b.tile
+		&& a.tag == b.tag && a.textureName == b.textureName;
+}
+
+bool EditJournal::readJournal(const std::string& path, JournalFile& file)
+{
+	std::ifstream in(path);
+	if (!in.is_open())
+	{
+		return false;
+	}
+	file.exists = true;
+
+	std::string line;
+	while (std::getline(in, line))
+	{
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		std::stringstream linestream(line);
+		std::string segment;
+		std::vector<std::string> seglist;
+		while (std::getline(linestream, segment, ','))
+		{
+			seglist.push_back(segment);
+		}
+		if (seglist.empty() || seglist[0].size() != 1) continue;
+
+		// A line cut short by a crash fails to parse and is skipped
+		try
+		{
+			char type = seglist[0][0];
+			if (type == 'B' && seglist.size() >= 3)
+			{
+				file.hasBase = true;
+				file.baseHash = std::stoull(seglist[1], nullptr, 16);
+				file.chained = seglist[2] == "1";
+			}
+			else if ((type == 'A' || type == 'M') && seglist.size() >= 11)
+			{
+				Record record;
+				record.type = type;
+				record.id = (unsigned int)std::stoul(seglist[1]);
+				record.tile.tag = seglist[2];
+				record.tile.position = sf::Vector2f(std::stof(seglist[3]), std::stof(seglist[4]));
+				record.tile.size = sf::Vector2f(std::stof(seglist[5]), std::stof(seglist[6]));
+				record.tile.trigger = std::stoi(seglist[7]);
+				record.tile.isStatic = std::stoi(seglist[8]);
+				record.tile.massless = std::stoi(seglist[9]);
+				record.tile.tile = std::stoi(seglist[10]);
+				if (seglist.size() > 11) record.tile.textureName = seglist[11];
+				file.records.push_back(record);
+			}
+			else if (type == 'D' && seglist.size() >= 2)
+			{
+				Record record;
+				record.type = type;
+				record.id = (unsigned int)std::stoul(seglist[1]);
+				file.records.push_back(record);
+			}
+		}
+		catch (const std::exception&)
+		{
+		}
+	}
+	return true;
+}
+
+void EditJournal::applyRecords(const std::vector<Record>& records, std::vector<LevelTile>& tiles, std::vector<bool>& alive)
+{
+	for (const Record& record : records)
+	{
+		if (record.type == 'A')
+		{
+			if (record.id >= tiles.size())
+			{
+				tiles.resize(record.id + 1);
+				alive.resize(record.id + 1, false);
+			}
+			tiles[record.id] = record.tile;
+			alive[record.id] = true;
+		}
+		else if (record.id < tiles.size() && alive[record.id])
+		{
+			if (record.type == 'M') tiles[record.id] = record.tile;
+			else alive[record.id] = false;
+		}
+	}
+}
+
+// FNV-1a over the file contents. A missing or empty file hashes the same as an empty level.
+uint64_t EditJournal::hashFile(const std::string& path)
+{
+	uint64_t hash = 14695981039346656037ull;
+	MappedFile file;
+	if (!file.open(path))
+	{
+		return hash;
+	}
+	const unsigned char* data = (const unsigned char*)file.getData();
+	for (size_t i = 0; i < file.getSize(); i++)
+	{
+		hash = (hash ^ data[i]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+// The temporary file keeps the level's format, whatever its own extension
+bool EditJournal::writeLevel(const std::string& path, const std::vector<LevelTile>& tiles) const
+{
+	return LevelFile::isBinary(levelPath) ? LevelFile::writeBinary(path, tiles) : LevelFile::writeCsv(path, tiles);
+}
+
+void EditJournal::writeRecord(char type, unsigned int id, const LevelTile* tile)
+{
+	if (!journal.is_open()) return;
+
+	journal << type << "," << id;
+	if (tile)
+	{
+		journal << "," << tile->tag << ","
+			<< tile->position.x << ","
+			<< tile->position.y << ","
+			<< tile->size.x << ","
+			<< tile->size.y << ","
+			<< tile->trigger << ","
+			<< tile->isStatic << ","
+			<< tile->massless << ","
+			<< tile->tile << ","
+			<< tile->textureName;
+	}
+	journal << "\n";
+	recordCount++;
+}
+
+void EditJournal::writeBaseLine(uint64_t hash, bool chained)
+{
+	journal << "B," << std::hex << hash << std::dec << "," << (chained ? 1 : 0) << "\n";
+	journal.flush();
+}
@@ -0,0 +1,101 @@
+// Edit Journal Class
+// Records tile editor changes as they happen by appending one line per add, modify or delete to <level>.journal.
+// Edits survive a crash without the editor having to rewrite the whole level file each time.
+// Compaction writes the full level on a background thread and starts a fresh journal, so the journal stays short.
+//
+// Journal lines
+//   B,<hash>,<chained>    Base the following records apply to: the level file with this content hash. If chained is 1
+//                         they apply to that file after <level>.journal.old has been replayed on top of it.
+//   A,<id>,<tag>,<x>,<y>,<width>,<height>,<trigger>,<static>,<massless>,<tile>,<texture>
+//   M,<id>,...            Same fields as A
+//   D,<id>
+// Tile ids are positions in the base file; new tiles take the next unused id. Ids are renumbered to the tile order
+// whenever a journal is compacted, so the caller must renumber its tiles to match.
+
+#pragma once
+#include "LevelFile.h"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+class EditJournal
+{
+public:
+	EditJournal();
+	~EditJournal();
+
+	// Inspect the level's journals and start journalling to it. Recovers from, or discards, leftovers of an interrupted compaction.
+	bool open(const std::string& levelPath);
+	void close();
+
+	// True if the journals hold changes not yet in the level file. If so the level must be loaded with replay().
+	bool hasEdits() const { return !oldRecords.empty() || !journalRecords.empty(); }
+	// Level file plus journalled changes. ids receives each tile's journal id.
+	bool replay(std::vector<LevelTile>& tiles, std::vector<unsigned int>& ids);
+	// True if replay() had to finish an interrupted compaction. The caller should then compactNow().
+	bool needsRecovery() const { return recoveryNeeded; }
+
+	void recordAdd(unsigned int id, const LevelTile& tile);
+	void recordModify(unsigned int id, const LevelTile& tile);
+	void recordDelete(unsigned int id);
+	// Records are buffered, so a large edit is one write rather than one per tile. Call once per frame.
+	void flush();
+	int getRecordCount() const { return recordCount; }
+
+	// Write snapshot as the level file on a background thread and rotate the journal. Snapshot ids are their index.
+	// Returns false if a compaction is already running.
+	bool compact(std::vector<LevelTile> snapshot);
+	// Write snapshot as the level file straight away and replace the journals with an empty one
+	bool compactNow(const std::vector<LevelTile>& snapshot);
+	bool isCompacting() const { return compactThread.joinable(); }
+	// Finish a background compaction once its thread is done. Call once per frame.
+	void update();
+	// Block until a background compaction has finished
+	void wait();
+
+	static bool sameTile(const LevelTile& a, const LevelTile& b);
+
+private:
+	struct Record
+	{
+		char type;
+		unsigned int id;
+		LevelTile tile;
+	};
+
+	struct JournalFile
+	{
+		bool exists = false;
+		bool hasBase = false;
+		uint64_t baseHash = 0;
+		bool chained = false;
+		std::vector<Record> records;
+	};
+
+	static bool readJournal(const std::string& path, JournalFile& journal);
+	static void applyRecords(const std::vector<Record>& records, std::vector<LevelTile>& tiles, std::vector<bool>& alive);
+	static uint64_t hashFile(const std::string& path);
+	bool writeLevel(const std::string& path, const std::vector<LevelTile>& tiles) const;
+	void writeRecord(char type, unsigned int id, const LevelTile* tile);
+	void writeBaseLine(uint64_t hash, bool chained);
+
+	std::string levelPath;
+	std::string journalPath;
+	std::string oldJournalPath;
+	uint64_t baseHash;
+	std::ofstream journal;
+	int recordCount;
+
+	std::vector<Record> oldRecords;
+	std::vector<Record> journalRecords;
+	bool recoveryNeeded;
+
+	std::thread compactThread;
+	std::atomic<bool> compactDone;
+	bool compactSucceeded;
+	uint64_t compactHash;
+	sf::Clock compactClock;
+};
@@ -1,17 +1,20 @@
 #include "GameObject.h"
 
+// Tags checked by the collision code, interned once so comparisons are between ids
+static const TagId enemyTag = Tags::getId("Enemy");
+static const TagId collectableTag = Tags::getId("Collectable");
+static const TagId wallTag = Tags::getId("Wall");
+
 GameObject::GameObject()
 {
     input = nullptr;
+    audio = nullptr;
     window = nullptr;
     alive = true;
     Colliding = false;
-
-    collisionBoxDebug.setFillColor(sf::Color::Transparent);
-    collisionBoxDebug.setOutlineColor(sf::Color::Red);
-    collisionBoxDebug.setOutlineThickness(1.f);
-
-
+    canJump = false;
+    angularVelocity = 0.f;
+    torque = 0.f;
 }
 
 GameObject::~GameObject()
@@ -31,73 +34,86 @@ void GameObject::update(float dt)
 
 void GameObject::updateCollisionBox(float dt)
 {
-    collisionBox = sf::FloatRect(getPosition().x, getPosition().y, getSize().x, getSize().y);
-    setDebugCollisionBox(getPosition().x, getPosition().y, getSize().x, getSize().y);
+    PhysicsBody& physics = body.get();
+    physics.aabb = sf::FloatRect(physics.position.x, physics.position.y, getSize().x, getSize().y);
+}
+
+// Writes the position to the physics body, and mirrors it into the shape so it is drawn there
+void GameObject::setPosition(float x, float y)
+{
+    setPosition(sf::Vector2f(x, y));
+}
+void GameObject::setPosition(const sf::Vector2f& position)
+{
+    body.get().position = position;
+    sf::RectangleShape::setPosition(position);
+}
+void GameObject::move(float offsetX, float offsetY)
+{
+    setPosition(body.get().position + sf::Vector2f(offsetX, offsetY));
+}
+void GameObject::move(const sf::Vector2f& offset)
+{
+    setPosition(body.get().position + offset);
 }
 
 // Sets the velocity of the sprite
 void GameObject::setVelocity(sf::Vector2f vel)
 {
-    if (!isStatic)
+    if (!getStatic())
     {
-        velocity = vel;
+        body.get().velocity = vel;
     }
 }
 void GameObject::setVelocity(float vx, float vy)
 {
-    if (!isStatic)
-    {
-        velocity.x = vx;
-        velocity.y = vy;
-    }
+    setVelocity(sf::Vector2f(vx, vy));
 }
 
 void GameObject::applyImpulse(sf::Vector2f impulse)
 {
-    if (!isStatic)
+    if (!getStatic())
     {
-        velocity += impulse / mass;
+        body.get().velocity += impulse / mass;
     }
 }
 
-// get sprite velocity
-sf::Vector2f GameObject::getVelocity()
-{
-    return velocity;
-}
-
-// Returns collision box + position, giving the collision box in the correct position
-sf::FloatRect GameObject::getCollisionBox() {
-
-    return collisionBox;
-
-}
-
-void GameObject::setDebugCollisionBox(float x, float y, float w, float h)
+// Debug outline of the collision box. Built on demand so the physics step never touches debug geometry.
+sf::RectangleShape GameObject::getDebugCollisionBox()
 {
-    collisionBoxDebug.setPosition(sf::Vector2f(x, y));
-    collisionBoxDebug.setSize(sf::Vector2f(w, h));
+    const sf::FloatRect collisionBox = getCollisionBox();
+    sf::RectangleShape shape(sf::Vector2f(collisionBox.width, collisionBox.height));
+    shape.setPosition(collisionBox.left, collisionBox.top);
+    shape.setFillColor(sf::Color::Transparent);
+    shape.setOutlineColor(getDebugColor());
+    shape.setOutlineThickness(1.f);
+    return shape;
 }
 
 bool GameObject::checkCollision(GameObject* otherBox)
 {
+    const TagId tag = getTagId();
+    const bool isTrigger = getTrigger();
+    const bool isStatic = getStatic();
+
     // Skip collision detection if both objects are tiles
-    if (isTile && otherBox->getTile()) {
+    if (getTile() && otherBox->getTile()) {
         return false; // No collision detection between two tiles
     }
 
-    if (otherBox->getTag() == "Collectable" && tag =="Enemy" || otherBox->getTag() == "Enemy" && tag == "Collectable")
+    if (otherBox->getTagId() == collectableTag && tag == enemyTag || otherBox->getTagId() == enemyTag && tag == collectableTag)
     {
 		return false;
 	}
 
     //Check if both objects are tagged as Enemy if they are , skip collision detection
     // This is to prevent the enemy from colliding with each other
-    if (otherBox->getTag() == "Enemy" && tag == "Enemy")
+    if (otherBox->getTagId() == enemyTag && tag == enemyTag)
     {
 		return false;
 	}
     // Get the collision box for both objects
+    const sf::FloatRect collisionBox = getCollisionBox();
     sf::FloatRect otherCollisionBox = otherBox->getCollisionBox();
 
     // Use intersects to check if the objects are colliding
@@ -297,16 +313,16 @@ bool GameObject::checkCollision(GameObject* otherBox)
 void GameObject::collisionResponse(GameObject* collider)
 {
     // Check if collider is a tile and has a specific tag ("Wall" or "Collectable"), or if it is neither static nor a tile.
-    if ((collider->getTile() && (collider->getTag() == "Wall" || collider->getTag() == "Collectable")) ||
+    if ((collider->getTile() && (collider->getTagId() == wallTag || collider->getTagId() == collectableTag)) ||
         (!collider->getStatic() && !collider->getTile()))
     {
         // Update the colliding tag
-        collidingTag = collider->getTag();
+        body.get().collidingTag = collider->getTagId();
     }
 }
 void GameObject::Jump(float jumpHeight)
 {
-    velocity.y = -sqrt(2.0f * 981.0f * jumpHeight);
+    body.get().velocity.y = -sqrt(2.0f * 981.0f * jumpHeight);
     canJump = false;
 }
 
@@ -344,9 +360,10 @@ std::string GameObject::getCollisionDirection()
 void GameObject::UpdatePhysics(sf::Vector2f* gravity, float deltaTime)
 {
 
-    if (!isStatic)
+    if (!getStatic())
     {
-        if (!isMassless)
+        sf::Vector2f& velocity = body.get().velocity;
+        if (!getMassless())
         {
             velocity.y += gravity->y * deltaTime;
 
@@ -2,6 +2,8 @@
 // A class representing a single renderable game object.
 // Game Object extend sf::RectangleShape, and added functionailty for collision, sprite states (alive/dead), velocity for movement, input component
 // Most elements of your game will extend game object to create larger more complex elements such as player, enemies, bullets etc.
+// Position, velocity, collision box, tags and collision flags live in the object's PhysicsBody record (see ObjectData.h).
+// The accessors here read and write that record, and position changes are mirrored into the shape so it draws in place.
 
 #pragma once
 #include <string>
@@ -9,6 +11,8 @@
 #include "SFML\Graphics.hpp"
 #include "Input.h"
 #include "AudioManager.h"
+#include "ObjectData.h"
+#include "Handle.h"
 
 class GameObject : public sf::RectangleShape
 {
@@ -20,12 +24,20 @@ public:
 	virtual void handleInput(float dt);
 	virtual void update(float dt);
 
+	// Position is kept in the PhysicsBody. These hide the sf::Transformable versions so the two stay in step;
+	// call them through a GameObject (or subclass), not through a base class reference.
+	void setPosition(float x, float y);
+	void setPosition(const sf::Vector2f& position);
+	sf::Vector2f getPosition() const { return body.get().position; }
+	void move(float offsetX, float offsetY);
+	void move(const sf::Vector2f& offset);
+
 	// Control sprite speed and direction
 	void setVelocity(sf::Vector2f vel);
 	void setVelocity(float vx, float vy);
 	void applyImpulse(sf::Vector2f impulse);
 
-	sf::Vector2f getVelocity();
+	sf::Vector2f getVelocity() const { return body.get().velocity; }
 
 	// Sprite state
 	bool isAlive() { return alive; };
@@ -34,13 +46,17 @@ public:
 	// For sprite collision, set collider box, get collider box, and dedicated virtual function for collision response
 	bool isColliding() { return Colliding; };
 	void setColliding(bool b) { Colliding = b; };
-	sf::FloatRect getCollisionBox();
+	sf::FloatRect getCollisionBox() const { return body.get().aabb; }
 	sf::Vector2f getHalfSize() { return sf::Vector2f(getSize().x / 2, getSize().y / 2); }
 
-	sf::RectangleShape getDebugCollisionBox() { return collisionBoxDebug; }
+	// Builds an outline shape of the collision box on request. Only needed when drawing debug information.
+	sf::RectangleShape getDebugCollisionBox();
+	sf::Color getDebugColor() const { return coldData.get().debugColor; }
 
-	std::string getTag() { return tag; }
-	bool CollisionWithTag(const std::string& otherTag) { return collidingTag == otherTag; }
+	const std::string& getTag() const { return Tags::getName(body.get().tag); }
+	TagId getTagId() const { return body.get().tag; }
+	bool CollisionWithTag(const std::string& otherTag) const { return body.get().collidingTag == Tags::findId(otherTag); }
+	bool CollisionWithTag(TagId otherTag) const { return body.get().collidingTag == otherTag; }
 
 	// Set the input component
 	void setInput(Input* in) { input = in; };
@@ -53,56 +69,64 @@ public:
 	//Called Every Frame in world class 
 	bool checkCollision(GameObject* other);
 	void collisionResponse(GameObject* collider);
-	void clearCollision() { collidingTag = ""; }
+	void clearCollision() { body.get().collidingTag = NoTag; }
 	void UpdatePhysics(sf::Vector2f* gravity, float deltaTime);
 
 	//Collision Types 
-	void setTrigger(bool t) { isTrigger = t; }
-	bool getTrigger() { return isTrigger; }
+	void setTrigger(bool t) { setFlag(PhysicsBody::TRIGGER, t); }
+	bool getTrigger() const { return hasFlag(PhysicsBody::TRIGGER); }
 
-	void setTile(bool t) { isTile = t; }
-	bool getTile() { return isTile; }
+	void setTile(bool t) { setFlag(PhysicsBody::TILE, t); }
+	bool getTile() const { return hasFlag(PhysicsBody::TILE); }
 
-	void setStatic(bool s) { isStatic = s; }
-	bool getStatic() { return isStatic; }
+	void setStatic(bool s) { setFlag(PhysicsBody::STATIC, s); }
+	bool getStatic() const { return hasFlag(PhysicsBody::STATIC); }
 
-	void setMassless(bool m) { isMassless = m; }
-	bool getMassless() { return isMassless; }
+	void setMassless(bool m) { setFlag(PhysicsBody::MASSLESS, m); }
+	bool getMassless() const { return hasFlag(PhysicsBody::MASSLESS); }
 	float getMass() const
 	{
-		return isStatic ? std::numeric_limits<float>::infinity() : mass;
+		return getStatic() ? std::numeric_limits<float>::infinity() : mass;
 	}
 
 	float getInverseMass() const
 	{
 		// If the object is static, return 0, as the inverse of infinity is 0
 		// This represents an immovable object in the physics simulation
-		return isStatic ? 0.0f : inverseMass;
+		return getStatic() ? 0.0f : inverseMass;
 	}
-	void setColor(sf::Color c) { collisionBoxDebug.setOutlineColor(c); }
-	void setTag(const std::string& t) { tag = t; }
+	void setColor(sf::Color c) { coldData.get().debugColor = c; }
+	void setTag(const std::string& t) { body.get().tag = Tags::getId(t); }
+	void setTagId(TagId t) { body.get().tag = t; }
+
+
+	void setTextureName(const std::string& name) { coldData.get().textureName = name; }
+	const std::string& getTextureName() const { return coldData.get().textureName; }
 
+	// Draw order used by the SpriteBatch. Lower layers are drawn first.
+	void setRenderLayer(int layer) { coldData.get().renderLayer = layer; }
+	int getRenderLayer() const { return coldData.get().renderLayer; }
 
-	void setTextureName(const std::string& name) { textureName = name; }
-	std::string getTextureName() const { return textureName; }
+	// Slot of the object's hot record in the PhysicsBodyTable, which the World's collision pass reads directly
+	ObjectHandle getBodyHandle() const { return body.getHandle(); }
+
+	// Set by the World while the object is added to it, invalid otherwise
+	void setWorldHandle(Handle h) { worldHandle = h; }
+	Handle getWorldHandle() const { return worldHandle; }
 
 protected:
 	// Collision functions
 	void setCollisionBox(float x, float y, float width, float height)
 	{
-		collisionBox = sf::FloatRect(x, y, width, height);
-		setDebugCollisionBox(x, y, width, height);
+		body.get().aabb = sf::FloatRect(x, y, width, height);
 	};
 	void setCollisionBox(sf::Vector2f pos, sf::Vector2f size)
 	{
-		collisionBox = sf::FloatRect(pos.x, pos.y, size.x, size.y);
-		setDebugCollisionBox(pos.x, pos.y, size.x, size.y);
-
+		body.get().aabb = sf::FloatRect(pos.x, pos.y, size.x, size.y);
 	}
 	void setCollisionBox(sf::FloatRect fr)
 	{
-		collisionBox = fr;
-		setDebugCollisionBox(fr.left, fr.top, fr.width, fr.height);
+		body.get().aabb = fr;
 	};
 
 	void updateCollisionBox(float dt);
@@ -113,12 +137,12 @@ protected:
 		mass = m;
 		if (mass == 0) // If mass is 0, the object is static
 		{
-			isStatic = true;
+			setStatic(true);
 			inverseMass = 0;
 		}
 		else //else object is not static 
 		{
-			isStatic = false;
+			setStatic(false);
 			inverseMass = 1 / mass;
 		}
 	}
@@ -136,12 +160,9 @@ protected:
 	void setAngularVelocity(float av) { angularVelocity = av; }
 	float getAngularVelocity() const { return angularVelocity; }
 
-	void setDebugCollisionBox(float x, float y, float w, float h);
-
 	void Jump(float jumpHeight);
 
 	// Sprite properties
-	sf::Vector2f velocity;
 	bool alive;
 	bool canJump;
 
@@ -150,10 +171,12 @@ protected:
 	AudioManager* audio;
 	sf::RenderWindow* window;
 private:
-	bool isStatic;
-	bool isTrigger;
-	bool isTile;
-	bool isMassless;
+	void setFlag(unsigned char flag, bool on)
+	{
+		if (on) body.get().flags |= flag;
+		else body.get().flags &= ~flag;
+	}
+	bool hasFlag(unsigned char flag) const { return (body.get().flags & flag) != 0; }
 
 
 	//Movement variables
@@ -171,13 +194,13 @@ private:
 	float inverseInertia = 0.002f;
 
 	// Collision vars
-	sf::FloatRect collisionBox;
-	sf::RectangleShape collisionBoxDebug;
 	bool Colliding;
 
-	//Textures
-	std::string textureName;
+	// Position, velocity, collision box, tags and flags, in the hot data table
+	PhysicsBodyRef body;
+
+	// Texture name, debug colour and render layer, kept out of the object in the cold data table
+	ObjectColdRef coldData;
 
-	std::string tag;
-	std::string collidingTag;
+	Handle worldHandle;
 };
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "Handle.h"
+
+Handle HandleTable::allocate(uint32_t dense)
+{
+	uint32_t index;
+	if (!freeSlots.empty())
+	{
+		index = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		index = (uint32_t)slots.size();
+		slots.push_back(Slot());
+	}
+	slots[index].dense = dense;
+	aliveCount++;
+
+	Handle handle;
+	handle.index = index;
+	handle.generation = slots[index].generation;
+	return handle;
+}
+
+void HandleTable::release(Handle handle)
+{
+	if (!isAlive(handle)) return;
+	slots[handle.index].generation++;
+	freeSlots.push_back(handle.index);
+	aliveCount--;
+}
+
+bool HandleTable::isAlive(Handle handle) const
+{
+	return handle.index < slots.size() && slots[handle.index].generation == handle.generation;
+}
+
+void HandleTable::clear()
+{
+	// Bump every live slot rather than dropping the table, so handles from before the clear stay stale
+	freeSlots.clear();
+	for (uint32_t i = 0; i < slots.size(); ++i)
+	{
+		slots[i].generation++;
+		freeSlots.push_back(i);
+	}
+	aliveCount = 0;
+}
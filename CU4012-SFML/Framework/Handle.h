@@ -0,0 +1,48 @@
+// Handle Class
+// Generational handle into a densely packed array, used by the World for its objects and the TileManager for its tiles.
+// The table maps a stable slot to the object's current position in the array, so owners can remove with swap-and-pop.
+// Releasing a slot bumps its generation, so an old handle to a removed object is never mistaken for whatever reuses the slot.
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct Handle
+{
+	static const uint32_t InvalidIndex = 0xFFFFFFFF;
+
+	uint32_t index = InvalidIndex;
+	uint32_t generation = 0;
+
+	bool operator==(const Handle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const Handle& other) const { return !(*this == other); }
+};
+
+class HandleTable
+{
+public:
+	// Returns a new handle pointing at position dense in the owner's array. Released slots are reused first.
+	Handle allocate(uint32_t dense);
+	// Invalidates the handle. Does nothing if it is already stale.
+	void release(Handle handle);
+	bool isAlive(Handle handle) const;
+
+	// Position of the object in the owner's array. Only valid for live handles.
+	uint32_t getDense(Handle handle) const { return slots[handle.index].dense; }
+	// Called by the owner after moving an object, e.g. the last element during swap-and-pop.
+	void setDense(Handle handle, uint32_t dense) { slots[handle.index].dense = dense; }
+
+	// Invalidates every handle given out so far.
+	void clear();
+	int getAliveCount() const { return aliveCount; }
+
+private:
+	struct Slot
+	{
+		uint32_t dense = 0;
+		uint32_t generation = 0;
+	};
+	std::vector<Slot> slots;
+	std::vector<uint32_t> freeSlots;
+	int aliveCount = 0;
+};
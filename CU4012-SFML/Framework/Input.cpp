@@ -4,11 +4,46 @@
 Input::Input()
 {
 	// set default values
-	mouse.left = MouseState::UP;
-	mouse.right = MouseState::UP;
+	mouse.buttons = 0;
+	mouse.previousButtons = 0;
+	mouse.tappedButtons = 0;
 	mouse.x = 0;
 	mouse.y = 0;
 	mouse.wheelDelta = 0;  // Initialize wheel delta
+	events.reserve(64);
+}
+
+// Add an event to the end of the queue
+void Input::recordEvent(InputEvent::Type type, int code, int x, int y)
+{
+	// Only the latest position of a run of moves matters, so a fast mouse adds one entry rather than hundreds
+	if (type == InputEvent::MouseMoved && !events.empty() && events.back().type == InputEvent::MouseMoved)
+	{
+		events.back().x = x;
+		events.back().y = y;
+		return;
+	}
+	InputEvent event;
+	event.type = type;
+	event.code = code;
+	event.x = x;
+	event.y = y;
+	events.push_back(event);
+}
+
+// Where the button first went down this frame, which can differ from the current position at low frame rates
+bool Input::getMousePressPosition(InputEvent::Button button, int& x, int& y) const
+{
+	for (const InputEvent& event : events)
+	{
+		if (event.type == InputEvent::MousePressed && event.code == button)
+		{
+			x = event.x;
+			y = event.y;
+			return true;
+		}
+	}
+	return false;
 }
 
 // Set the mouse wheel delta
@@ -33,62 +68,84 @@ void Input::clearMouseWheelDelta()
 // Set a specific key state to true/down.
 void Input::setKeyDown(int key)
 {
-	if (key >= 0)
+	if (key >= 0 && key < KeyWords * 64)
 	{
-		keys[key] = true;
+		keys[key >> 6] |= 1ull << (key & 63);
 	}
 }
 
 // Set a specific key state to false/up.
 void Input::setKeyUp(int key)
 {
-	if (key >= 0)
+	if (key >= 0 && key < KeyWords * 64)
 	{
-		keys[key] = false;
+		uint64_t bit = 1ull << (key & 63);
+		// Down and up again before the end of the frame, remember the press
+		if ((keys[key >> 6] & ~previousKeys[key >> 6]) & bit)
+		{
+			tappedKeys[key >> 6] |= bit;
+		}
+		keys[key >> 6] &= ~bit;
 	}
 }
 
 // Check if a key is currently down. Returns true if key is down.
 bool Input::isKeyDown(int key)
 {
-	if (key >= 0)
+	if (key >= 0 && key < KeyWords * 64)
 	{
-		return keys[key];
+		return (keys[key >> 6] >> (key & 63)) & 1;
 	}
 	return false;
 }
 
-// Check if a key is pressed. Currently down, but will be automatically set up at the end of frame.
+// Check if a key went down this frame: down now but not last frame, or tapped within the frame.
 bool Input::isPressed(int key)
 {
-	bool cond = isKeyDown(key);
-	if (cond)
+	if (key >= 0 && key < KeyWords * 64)
 	{
-		pressed.push_back(key);
-		return cond;
+		int w = key >> 6;
+		return (((keys[w] & ~previousKeys[w]) | tappedKeys[w]) >> (key & 63)) & 1;
 	}
 	return false;
 }
 
-// Updates current state of keys. Focuses on pressed states. If pressed and processed, should be set to up.
-void Input::update()
+// Check if a key came up this frame
+bool Input::isReleased(int key)
 {
-	for (int i = 0; i < pressed.size(); i++)
+	if (key >= 0 && key < KeyWords * 64)
 	{
-		setKeyUp(pressed[i]);
+		int w = key >> 6;
+		return (((~keys[w] & previousKeys[w]) | tappedKeys[w]) >> (key & 63)) & 1;
 	}
-	pressed.clear();
+	return false;
+}
 
-	if (mouse.left == MouseState::PRESSED)
+bool Input::anyKeyPressed()
+{
+	uint64_t pressed = 0;
+	for (int w = 0; w < KeyWords; w++)
 	{
-		mouse.left = MouseState::UP;
+		pressed |= (keys[w] & ~previousKeys[w]) | tappedKeys[w];
 	}
-	if (mouse.right == MouseState::PRESSED)
+	return pressed != 0;
+}
+
+// Ends the frame. Current key and button states become the previous ones for next frame's edge queries.
+void Input::update()
+{
+	for (int w = 0; w < KeyWords; w++)
 	{
-		mouse.right = MouseState::UP;
+		previousKeys[w] = keys[w];
+		tappedKeys[w] = 0;
 	}
+	mouse.previousButtons = mouse.buttons;
+	mouse.tappedButtons = 0;
 
 	clearMouseWheelDelta();  // Reset the wheel delta at the end of each frame
+
+	// Events are only kept for the frame they arrived in
+	events.clear();
 }
 
 // Stores current mouse x-coordinate
@@ -122,57 +179,54 @@ int Input::getMouseY()
 	return mouse.y;
 }
 
+void Input::setButton(unsigned char bit, MouseState state)
+{
+	if (state == MouseState::UP)
+	{
+		if ((mouse.buttons & ~mouse.previousButtons) & bit)
+		{
+			mouse.tappedButtons |= bit;
+		}
+		mouse.buttons &= ~bit;
+	}
+	else
+	{
+		mouse.buttons |= bit;
+	}
+}
+
 // Set left mouse button state (UP, DOWN, PRESSED)
 void Input::setLeftMouse(MouseState state)
 {
-	mouse.left = state;
+	setButton(1, state);
 }
 
-// Checks if Left mouse button is down. Returning true if button is DOWN or PRESSED
+// Checks if Left mouse button is down.
 bool Input::isLeftMouseDown()
 {
-	if (mouse.left == MouseState::DOWN || mouse.left == MouseState::PRESSED)
-	{
-		return true;
-	}
-	return false;
+	return (mouse.buttons & 1) != 0;
 }
 
-// Checks if left mouse button is pressed. If set to DOWN, is updated to PRESSED. Automatically updated in update().
+// Checks if left mouse button went down this frame.
 bool Input::isLeftMousePressed()
 {
-	if (mouse.left == MouseState::DOWN || mouse.left == MouseState::PRESSED)
-	{
-		mouse.left = MouseState::PRESSED;
-		return true;
-	}
-	return false;
+	return (((mouse.buttons & ~mouse.previousButtons) | mouse.tappedButtons) & 1) != 0;
 }
 
 // Set right mouse button state (UP, DOWN, PRESSED)
 void Input::setRightMouse(MouseState state)
 {
-	mouse.right = state;
+	setButton(2, state);
 }
 
-// Checks if right mouse button is down. Returning true if button is DOWN or PRESSED
+// Checks if right mouse button is down.
 bool Input::isRightMouseDown()
 {
-	if (mouse.right == MouseState::DOWN || mouse.right == MouseState::PRESSED)
-	{
-		return true;
-	}
-	return false;
+	return (mouse.buttons & 2) != 0;
 }
 
-// Checks if right mouse button is pressed. If set to DOWN, is updated to PRESSED. Automatically updated in update().
+// Checks if right mouse button went down this frame.
 bool Input::isRightMousePressed()
 {
-	if (mouse.right == MouseState::DOWN || mouse.right == MouseState::PRESSED)
-	{
-		mouse.right = MouseState::PRESSED;
-		return true;
-	}
-	return false;
+	return (((mouse.buttons & ~mouse.previousButtons) | mouse.tappedButtons) & 2) != 0;
 }
-
@@ -1,10 +1,24 @@
 // Input class
 // Class stores the current state on keyboard and mouse input.
 // Store which keys are pressed or released, mouse position and mouse button presses.
+// Keys are held in bitsets for this frame and the last, so "went down" and "came up" this frame are a mask test.
+// Alongside the state, every key and mouse event of the frame is kept in order, so code that cares where or in what
+// order things happened within the frame (e.g. where a click landed) can find out.
 
 #pragma once
+#include <cstdint>
 #include <vector>
 
+struct InputEvent
+{
+	enum Type : unsigned char { KeyPressed, KeyReleased, MousePressed, MouseReleased, MouseMoved, MouseWheel };
+	enum Button { Left = 0, Right = 1 };
+
+	Type type;
+	int code;	// Key code, or Button for mouse presses and releases
+	int x, y;	// Mouse position, or wheel delta in x
+};
+
 class Input
 {
 public:
@@ -14,7 +28,7 @@ private:
 	struct Mouse
 	{
 		int x, y;
-		MouseState left, right;
+		unsigned char buttons, previousButtons, tappedButtons; // Bit per button, as keys
 		int wheelDelta;  // Store wheel scroll delta here
 	};
 	
@@ -24,7 +38,12 @@ public:
 	void setKeyDown(int key);
 	void setKeyUp(int key);
 	bool isKeyDown(int key);
+	// True only in the frame the key went down (or was tapped), so holding it does not repeat
 	bool isPressed(int key);
+	// True only in the frame the key came up
+	bool isReleased(int key);
+	bool anyKeyPressed();
+	// Ends the frame: this frame's keys become the previous ones. Call once per frame, after everything has read input.
 	void update();
 
 	// Functions are mouse input, including getting and setting current position and mouse button presses.
@@ -34,6 +53,7 @@ public:
 	int getMouseX();
 	int getMouseY();
 
+	// PRESSED is treated as DOWN. Pressed queries report the frame the button went down.
 	void setLeftMouse(MouseState state);
 	bool isLeftMouseDown();
 	bool isLeftMousePressed();
@@ -46,11 +66,27 @@ public:
 	void setMouseWheelDelta(int delta);
 	int getMouseWheelDelta();
 	void clearMouseWheelDelta(); // To reset the delta after each frame
+
+	// Event queue, holding the events since the last update(). Nothing is dropped; consecutive moves are merged into one.
+	// Events are not timestamped: SFML hands them all over at the start of the frame, so a stamp would only give the poll time.
+	void recordEvent(InputEvent::Type type, int code, int x = 0, int y = 0);
+	int getEventCount() const { return (int)events.size(); }
+	// Events in arrival order, 0 is the oldest
+	const InputEvent& getEvent(int index) const { return events[index]; }
+	// Position of the first press of the button this frame. False if it was not pressed.
+	bool getMousePressPosition(InputEvent::Button button, int& x, int& y) const;
 	
 private:
-	// Array of booleans representing keys (pressed = true, released = false)
-	bool keys[256]{ false };
-	std::vector<int> pressed;
+	// Bitsets of 256 keys (down = 1). Tapped keys went down and up within the frame, and still count as pressed.
+	static const int KeyWords = 4;
+	uint64_t keys[KeyWords]{};
+	uint64_t previousKeys[KeyWords]{};
+	uint64_t tappedKeys[KeyWords]{};
+
+	void setButton(unsigned char bit, MouseState state);
 	// Mouse variable
 	Mouse mouse;
+
+	// This frame's events
+	std::vector<InputEvent> events;
 };
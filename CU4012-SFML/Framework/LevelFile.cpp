@@ -0,0 +1,302 @@
+#include "LevelFile.h"
+#include "AssetCache.h"
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+
+bool LevelFileView::open(const std::string& path)
+{
+	close();
+	// The editor saves levels as loose files, so those win over a packed copy
+	const char* data;
+	size_t size;
+	if (file.open(path))
+	{
+		data = file.getData();
+		size = file.getSize();
+	}
+	else if (!AssetCache::get().getPack().find(path, data, size))
+	{
+		return false;
+	}
+
+	// Check every section lies inside the file before handing out pointers into it
+	const LevelFileHeader* h = (const LevelFileHeader*)data;
+	if (size < sizeof(LevelFileHeader) || h->magic != LevelFileMagic || h->version != LevelFileVersion
+		|| h->tileOffset + (uint64_t)h->tileCount * sizeof(LevelTileRecord) > size
+		|| h->stringOffset + (uint64_t)h->stringCount * sizeof(uint32_t) > size
+		|| h->stringDataOffset + (uint64_t)h->stringDataSize > size
+		|| h->stringCount == 0 || h->stringDataSize == 0 || data[h->stringDataOffset + h->stringDataSize - 1] != '\0')
+	{
+		std::cerr << "Invalid level file: " << path << std::endl;
+		file.close();
+		return false;
+	}
+
+	header = h;
+	tiles = (const LevelTileRecord*)(data + h->tileOffset);
+	stringOffsets = (const uint32_t*)(data + h->stringOffset);
+	stringData = data + h->stringDataOffset;
+	return true;
+}
+
+const char* LevelFileView::getString(uint32_t index) const
+{
+	if (index >= header->stringCount || stringOffsets[index] >= header->stringDataSize)
+	{
+		return "";
+	}
+	return stringData + stringOffsets[index];
+}
+
+bool CsvTileReader::open(const std::string& path)
+{
+	cursor = end = nullptr;
+	lineNumber = 0;
+	if (!file.open(path))
+	{
+		// An empty file cannot be mapped but is still a valid, empty level
+		std::error_code error;
+		if (std::filesystem::exists(path, error) && std::filesystem::file_size(path, error) == 0)
+		{
+			return true;
+		}
+		size_t size;
+		if (AssetCache::get().getPack().find(path, cursor, size))
+		{
+			end = cursor + size;
+			return true;
+		}
+		std::cout << "Failed to open file for loading tiles." << std::endl;
+		return false;
+	}
+	cursor = file.getData();
+	end = cursor + file.getSize();
+	return true;
+}
+
+namespace
+{
+	// stof/stoi skip leading whitespace and accept a leading '+', from_chars does not
+	const char* skipNumberPrefix(const char* first, const char* last)
+	{
+		while (first < last && (*first == ' ' || *first == '\t')) first++;
+		if (first < last && *first == '+') first++;
+		return first;
+	}
+
+	// Like stof/stoi, parse the leading number and ignore anything after it
+	bool parseFloat(std::string_view field, float& value)
+	{
+		const char* first = skipNumberPrefix(field.data(), field.data() + field.size());
+		return std::from_chars(first, field.data() + field.size(), value).ec == std::errc();
+	}
+
+	bool parseFlag(std::string_view field, bool& value)
+	{
+		int number = 0;
+		const char* first = skipNumberPrefix(field.data(), field.data() + field.size());
+		if (std::from_chars(first, field.data() + field.size(), number).ec != std::errc()) return false;
+		value = number != 0;
+		return true;
+	}
+}
+
+bool CsvTileReader::next(CsvTile& tile)
+{
+	while (cursor < end)
+	{
+		const char* lineEnd = (const char*)memchr(cursor, '\n', end - cursor);
+		if (lineEnd == nullptr) lineEnd = end;
+		const char* lineStart = cursor;
+		cursor = lineEnd < end ? lineEnd + 1 : end;
+		lineNumber++;
+
+		const char* last = lineEnd;
+		if (last > lineStart && last[-1] == '\r') last--;
+
+		// Split into at most ten fields. A trailing empty field does not count, as with getline.
+		std::string_view fields[10];
+		int fieldCount = 0;
+		const char* fieldStart = lineStart;
+		while (fieldCount < 10 && fieldStart < last)
+		{
+			const char* comma = (const char*)memchr(fieldStart, ',', last - fieldStart);
+			const char* fieldEnd = comma ? comma : last;
+			fields[fieldCount++] = std::string_view(fieldStart, fieldEnd - fieldStart);
+			if (!comma) break;
+			fieldStart = comma + 1;
+		}
+		if (fieldCount < 9) continue;
+
+		if (!parseFloat(fields[1], tile.position.x) || !parseFloat(fields[2], tile.position.y)
+			|| !parseFloat(fields[3], tile.size.x) || !parseFloat(fields[4], tile.size.y)
+			|| !parseFlag(fields[5], tile.trigger) || !parseFlag(fields[6], tile.isStatic)
+			|| !parseFlag(fields[7], tile.massless) || !parseFlag(fields[8], tile.tile))
+		{
+			std::cerr << "Skipping bad tile on line " << lineNumber << std::endl;
+			continue;
+		}
+		tile.tag = fields[0];
+		tile.textureName = fieldCount > 9 ? fields[9] : std::string_view();
+		return true;
+	}
+	return false;
+}
+
+bool LevelFile::isBinary(const std::string& path)
+{
+	return path.size() >= 4 && path.compare(path.size() - 4, 4, ".lvl") == 0;
+}
+
+bool LevelFile::readCsv(const std::string& path, std::vector<LevelTile>& tiles)
+{
+	CsvTileReader reader;
+	if (!reader.open(path))
+	{
+		return false;
+	}
+
+	CsvTile row;
+	while (reader.next(row))
+	{
+		LevelTile tile;
+		tile.tag = std::string(row.tag);
+		tile.position = row.position;
+		tile.size = row.size;
+		tile.trigger = row.trigger;
+		tile.isStatic = row.isStatic;
+		tile.massless = row.massless;
+		tile.tile = row.tile;
+		tile.textureName = std::string(row.textureName);
+		tiles.push_back(tile);
+	}
+	return true;
+}
+
+bool LevelFile::writeCsv(const std::string& path, const std::vector<LevelTile>& tiles)
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		std::cout << "Failed to open file for saving tiles." << std::endl;
+		return false;
+	}
+
+	for (const LevelTile& tile : tiles)
+	{
+		file << tile.tag << ","
+			<< tile.position.x << ","
+			<< tile.position.y << ","
+			<< tile.size.x << ","
+			<< tile.size.y << ","
+			<< tile.trigger << ","
+			<< tile.isStatic << ","
+			<< tile.massless << ","
+			<< tile.tile << ","
+			<< tile.textureName << "\n";
+	}
+	return true;
+}
+
+bool LevelFile::readBinary(const std::string& path, std::vector<LevelTile>& tiles)
+{
+	LevelFileView view;
+	if (!view.open(path))
+	{
+		return false;
+	}
+
+	tiles.reserve(tiles.size() + view.getTileCount());
+	for (uint32_t i = 0; i < view.getTileCount(); i++)
+	{
+		const LevelTileRecord& record = view.getTile(i);
+		LevelTile tile;
+		tile.tag = view.getString(record.tag);
+		tile.position = sf::Vector2f(record.x, record.y);
+		tile.size = sf::Vector2f(record.width, record.height);
+		tile.trigger = (record.flags & LevelTileRecord::TRIGGER) != 0;
+		tile.isStatic = (record.flags & LevelTileRecord::STATIC) != 0;
+		tile.massless = (record.flags & LevelTileRecord::MASSLESS) != 0;
+		tile.tile = (record.flags & LevelTileRecord::TILE) != 0;
+		tile.textureName = view.getString(record.texture);
+		tiles.push_back(tile);
+	}
+	return true;
+}
+
+bool LevelFile::writeBinary(const std::string& path, const std::vector<LevelTile>& tiles)
+{
+	// Build the string table, each distinct tag and texture name stored once
+	std::vector<uint32_t> stringOffsets;
+	std::string stringData;
+	std::unordered_map<std::string, uint32_t> stringIndices;
+	auto addString = [&](const std::string& text) -> uint32_t
+	{
+		auto it = stringIndices.find(text);
+		if (it != stringIndices.end()) return it->second;
+		uint32_t index = (uint32_t)stringOffsets.size();
+		stringOffsets.push_back((uint32_t)stringData.size());
+		stringData.append(text);
+		stringData.push_back('\0');
+		stringIndices[text] = index;
+		return index;
+	};
+	addString("");
+
+	std::vector<LevelTileRecord> records;
+	records.reserve(tiles.size());
+	for (const LevelTile& tile : tiles)
+	{
+		LevelTileRecord record;
+		record.x = tile.position.x;
+		record.y = tile.position.y;
+		record.width = tile.size.x;
+		record.height = tile.size.y;
+		record.tag = addString(tile.tag);
+		record.texture = addString(tile.textureName);
+		record.flags = 0;
+		if (tile.trigger) record.flags |= LevelTileRecord::TRIGGER;
+		if (tile.isStatic) record.flags |= LevelTileRecord::STATIC;
+		if (tile.massless) record.flags |= LevelTileRecord::MASSLESS;
+		if (tile.tile) record.flags |= LevelTileRecord::TILE;
+		records.push_back(record);
+	}
+
+	LevelFileHeader header;
+	header.magic = LevelFileMagic;
+	header.version = LevelFileVersion;
+	header.tileCount = (uint32_t)records.size();
+	header.tileOffset = sizeof(LevelFileHeader);
+	header.stringCount = (uint32_t)stringOffsets.size();
+	header.stringOffset = header.tileOffset + header.tileCount * sizeof(LevelTileRecord);
+	header.stringDataOffset = header.stringOffset + header.stringCount * sizeof(uint32_t);
+	header.stringDataSize = (uint32_t)stringData.size();
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file.is_open())
+	{
+		std::cout << "Failed to open file for saving tiles." << std::endl;
+		return false;
+	}
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)records.data(), records.size() * sizeof(LevelTileRecord));
+	file.write((const char*)stringOffsets.data(), stringOffsets.size() * sizeof(uint32_t));
+	file.write(stringData.data(), stringData.size());
+	return file.good();
+}
+
+bool LevelFile::convert(const std::string& fromPath, const std::string& toPath)
+{
+	std::vector<LevelTile> tiles;
+	bool loaded = isBinary(fromPath) ? readBinary(fromPath, tiles) : readCsv(fromPath, tiles);
+	if (!loaded)
+	{
+		return false;
+	}
+	std::cout << "Converting " << tiles.size() << " tiles from " << fromPath << " to " << toPath << std::endl;
+	return isBinary(toPath) ? writeBinary(toPath, tiles) : writeCsv(toPath, tiles);
+}
@@ -0,0 +1,122 @@
+// Level File
+// Reads and writes level tile data in two formats, chosen by file extension.
+//   .txt/.csv  The original comma-separated TilesData format, one tile per line.
+//   .lvl       Versioned binary format that is memory mapped and read in place:
+//              header, packed tile records, then a string table for tags and texture names.
+// Binary files are written in native byte order (little-endian on every platform we build for).
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+// Tile description used when converting between formats
+struct LevelTile
+{
+	std::string tag;
+	sf::Vector2f position;
+	sf::Vector2f size;
+	bool trigger = false;
+	bool isStatic = false;
+	bool massless = false;
+	bool tile = false;
+	std::string textureName;
+};
+
+const uint32_t LevelFileMagic = 0x4C56454C; // "LEVL"
+const uint32_t LevelFileVersion = 1;
+
+struct LevelFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t tileCount;
+	uint32_t tileOffset;		// Byte offset of the first LevelTileRecord
+	uint32_t stringCount;
+	uint32_t stringOffset;		// Byte offset of stringCount uint32_t offsets into the string data
+	uint32_t stringDataOffset;	// Byte offset of the null-terminated string data
+	uint32_t stringDataSize;
+};
+
+struct LevelTileRecord
+{
+	enum Flags : uint32_t { TRIGGER = 1, STATIC = 2, MASSLESS = 4, TILE = 8 };
+
+	float x, y;
+	float width, height;
+	uint32_t tag;		// String table index. Index 0 is always the empty string.
+	uint32_t texture;	// String table index
+	uint32_t flags;
+};
+
+// The file layout must not change without bumping LevelFileVersion
+static_assert(sizeof(LevelFileHeader) == 32, "LevelFileHeader layout changed");
+static_assert(sizeof(LevelTileRecord) == 28, "LevelTileRecord layout changed");
+
+// Read-only view of a mapped binary level. Records and strings point straight into the file.
+class LevelFileView
+{
+public:
+	bool open(const std::string& path);
+	void close() { file.close(); header = nullptr; }
+
+	uint32_t getTileCount() const { return header ? header->tileCount : 0; }
+	uint32_t getStringCount() const { return header ? header->stringCount : 0; }
+	const LevelTileRecord& getTile(uint32_t index) const { return tiles[index]; }
+	const char* getString(uint32_t index) const;
+
+private:
+	MappedFile file;
+	const LevelFileHeader* header = nullptr;
+	const LevelTileRecord* tiles = nullptr;
+	const uint32_t* stringOffsets = nullptr;
+	const char* stringData = nullptr;
+};
+
+// One CSV row. The strings point into the reader's mapped file and are only valid while the reader is open.
+struct CsvTile
+{
+	std::string_view tag;
+	sf::Vector2f position;
+	sf::Vector2f size;
+	bool trigger;
+	bool isStatic;
+	bool massless;
+	bool tile;
+	std::string_view textureName;
+};
+
+// Streams tiles out of a CSV level without allocating. The file is mapped and tokenised in place with std::from_chars.
+// Accepts the same rows as the original getline/stof loader: at least nine fields, an optional texture name tenth,
+// anything further ignored. Tag and texture may be empty. Rows with fewer fields are skipped, as are rows with bad numbers.
+class CsvTileReader
+{
+public:
+	bool open(const std::string& path);
+	// Reads the next valid row. Returns false once the file is exhausted.
+	bool next(CsvTile& tile);
+	int getLineNumber() const { return lineNumber; }
+
+private:
+	MappedFile file;
+	const char* cursor = nullptr;
+	const char* end = nullptr;
+	int lineNumber = 0;
+};
+
+namespace LevelFile
+{
+	// True for paths ending in .lvl
+	bool isBinary(const std::string& path);
+
+	bool readCsv(const std::string& path, std::vector<LevelTile>& tiles);
+	bool writeCsv(const std::string& path, const std::vector<LevelTile>& tiles);
+	bool readBinary(const std::string& path, std::vector<LevelTile>& tiles);
+	bool writeBinary(const std::string& path, const std::vector<LevelTile>& tiles);
+
+	// Format of each side is picked by extension, so this converts CSV to binary or back
+	bool convert(const std::string& fromPath, const std::string& toPath);
+}
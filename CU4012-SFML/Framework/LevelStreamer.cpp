@@ -0,0 +1,357 @@
+#include "LevelStreamer.h"
+#include "EditJournal.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cmath>
+
+LevelStreamer::LevelStreamer()
+{
+	world = nullptr;
+	textureManager = nullptr;
+	chunkSize = 1024.f;
+	loadMargin = 512.f;
+	tileCount = 0;
+	generation = 0;
+	stopping = false;
+}
+
+LevelStreamer::~LevelStreamer()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	jobAvailable.notify_all();
+	if (worker.joinable()) worker.join();
+	close();
+}
+
+bool LevelStreamer::buildChunks(const std::string& levelPath, const std::string& directory, float chunkSize)
+{
+	std::vector<LevelTile> tiles;
+	EditJournal journal;
+	journal.open(levelPath);
+	bool loaded;
+	if (journal.hasEdits())
+	{
+		std::vector<unsigned int> ids;
+		loaded = journal.replay(tiles, ids);
+	}
+	else
+	{
+		loaded = LevelFile::isBinary(levelPath) ? LevelFile::readBinary(levelPath, tiles) : LevelFile::readCsv(levelPath, tiles);
+	}
+	if (!loaded)
+	{
+		return false;
+	}
+	return writeChunks(tiles, directory, chunkSize);
+}
+
+int64_t LevelStreamer::getChunkKey(const sf::FloatRect& bounds, float chunkSize)
+{
+	int x = (int)std::floor((bounds.left + bounds.width / 2.f) / chunkSize);
+	int y = (int)std::floor((bounds.top + bounds.height / 2.f) / chunkSize);
+	return makeKey(x, y);
+}
+
+bool LevelStreamer::writeChunks(const std::vector<LevelTile>& tiles, const std::string& directory, float chunkSize,
+	const std::unordered_set<int64_t>* only)
+{
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	// Tiles belong to the chunk containing their centre. The chunk bounds grow to cover any tile that overhangs it.
+	struct Bucket
+	{
+		int x, y;
+		sf::FloatRect bounds;
+		std::vector<LevelTile> tiles;
+	};
+	std::unordered_map<int64_t, Bucket> buckets;
+	for (const LevelTile& tile : tiles)
+	{
+		sf::FloatRect tileBounds(tile.position, tile.size);
+		int64_t key = getChunkKey(tileBounds, chunkSize);
+
+		Bucket& bucket = buckets[key];
+		if (bucket.tiles.empty())
+		{
+			bucket.x = (int)(key >> 32);
+			bucket.y = (int)(uint32_t)key;
+			bucket.bounds = tileBounds;
+		}
+		else
+		{
+			float left = std::min(bucket.bounds.left, tileBounds.left);
+			float top = std::min(bucket.bounds.top, tileBounds.top);
+			float right = std::max(bucket.bounds.left + bucket.bounds.width, tileBounds.left + tileBounds.width);
+			float bottom = std::max(bucket.bounds.top + bucket.bounds.height, tileBounds.top + tileBounds.height);
+			bucket.bounds = sf::FloatRect(left, top, right - left, bottom - top);
+		}
+		bucket.tiles.push_back(tile);
+	}
+
+	std::ofstream index(directory + "/index.txt");
+	if (!index.is_open())
+	{
+		std::cerr << "Failed to write chunk index in " << directory << std::endl;
+		return false;
+	}
+	index << "chunkSize," << chunkSize << "\n";
+	int written = 0;
+	for (auto& entry : buckets)
+	{
+		Bucket& bucket = entry.second;
+		std::string name = "chunk_" + std::to_string(bucket.x) + "_" + std::to_string(bucket.y) + ".lvl";
+		if (!only || only->count(entry.first))
+		{
+			if (!LevelFile::writeBinary(directory + "/" + name, bucket.tiles))
+			{
+				return false;
+			}
+			written++;
+		}
+		index << "chunk," << bucket.x << "," << bucket.y << ","
+			<< bucket.bounds.left << "," << bucket.bounds.top << ","
+			<< bucket.bounds.width << "," << bucket.bounds.height << "\n";
+	}
+
+	// A chunk whose last tile was deleted or moved out is no longer in the index
+	if (only)
+	{
+		for (int64_t key : *only)
+		{
+			if (buckets.count(key)) continue;
+			std::string name = "chunk_" + std::to_string((int)(key >> 32)) + "_" + std::to_string((int)(uint32_t)key) + ".lvl";
+			std::filesystem::remove(directory + "/" + name, error);
+		}
+	}
+
+	std::cout << "Wrote " << written << " of " << buckets.size() << " chunks (" << tiles.size() << " tiles) in " << directory << std::endl;
+	return true;
+}
+
+bool LevelStreamer::open(const std::string& chunkDirectory)
+{
+	close();
+
+	std::ifstream index(chunkDirectory + "/index.txt");
+	if (!index.is_open())
+	{
+		std::cerr << "Failed to open chunk index in " << chunkDirectory << std::endl;
+		return false;
+	}
+	directory = chunkDirectory;
+
+	// Nothing to read until a chunk directory is opened, so the worker is only started then
+	if (!worker.joinable())
+	{
+		worker = std::thread(&LevelStreamer::workerLoop, this);
+	}
+
+	std::string line;
+	while (std::getline(index, line))
+	{
+		std::stringstream linestream(line);
+		std::string segment;
+		std::vector<std::string> seglist;
+		while (std::getline(linestream, segment, ','))
+		{
+			seglist.push_back(segment);
+		}
+
+		if (seglist.size() >= 2 && seglist[0] == "chunkSize")
+		{
+			chunkSize = std::stof(seglist[1]);
+		}
+		else if (seglist.size() >= 7 && seglist[0] == "chunk")
+		{
+			int x = std::stoi(seglist[1]);
+			int y = std::stoi(seglist[2]);
+			Chunk& chunk = chunks[makeKey(x, y)];
+			chunk.path = directory + "/chunk_" + seglist[1] + "_" + seglist[2] + ".lvl";
+			chunk.bounds = sf::FloatRect(std::stof(seglist[3]), std::stof(seglist[4]), std::stof(seglist[5]), std::stof(seglist[6]));
+		}
+	}
+	return true;
+}
+
+void LevelStreamer::close()
+{
+	for (auto& chunk : chunks)
+	{
+		unloadChunk(chunk.second);
+	}
+	chunks.clear();
+	generation++;
+
+	// Drop queued work; anything already being read is discarded when it arrives
+	std::lock_guard<std::mutex> lock(mutex);
+	jobs.clear();
+	results.clear();
+}
+
+void LevelStreamer::update(const sf::View& view)
+{
+	if (chunks.empty()) return;
+
+	// Take finished loads. A chunk that was closed, or is no longer wanted, while loading is simply left unloaded.
+	std::deque<LoadResult> finished;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		finished.swap(results);
+	}
+
+	sf::Vector2f viewSize = view.getSize();
+	sf::Vector2f viewCentre = view.getCenter();
+	sf::FloatRect loadArea(viewCentre.x - viewSize.x / 2.f - loadMargin, viewCentre.y - viewSize.y / 2.f - loadMargin,
+		viewSize.x + loadMargin * 2.f, viewSize.y + loadMargin * 2.f);
+	sf::FloatRect keepArea(loadArea.left - chunkSize, loadArea.top - chunkSize,
+		loadArea.width + chunkSize * 2.f, loadArea.height + chunkSize * 2.f);
+
+	for (LoadResult& result : finished)
+	{
+		auto it = chunks.find(result.key);
+		if (result.generation != generation || it == chunks.end() || it->second.state != ChunkState::Loading) continue;
+
+		if (it->second.bounds.intersects(keepArea))
+		{
+			createTiles(it->second, result.tiles);
+		}
+		else
+		{
+			it->second.state = ChunkState::Unloaded;
+		}
+	}
+
+	std::vector<LoadJob> requests;
+	for (auto& entry : chunks)
+	{
+		Chunk& chunk = entry.second;
+		if (chunk.state == ChunkState::Unloaded && chunk.bounds.intersects(loadArea))
+		{
+			chunk.state = ChunkState::Loading;
+			requests.push_back({ entry.first, generation, chunk.path });
+		}
+		else if (chunk.state == ChunkState::Loaded && !chunk.bounds.intersects(keepArea))
+		{
+			unloadChunk(chunk);
+		}
+	}
+
+	if (!requests.empty())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			jobs.insert(jobs.end(), requests.begin(), requests.end());
+		}
+		jobAvailable.notify_one();
+	}
+}
+
+int LevelStreamer::getLoadedChunkCount() const
+{
+	int count = 0;
+	for (auto& chunk : chunks)
+	{
+		if (chunk.second.state == ChunkState::Loaded) count++;
+	}
+	return count;
+}
+
+void LevelStreamer::createTiles(Chunk& chunk, const std::vector<LevelTile>& levelTiles)
+{
+	chunk.tiles.reserve(levelTiles.size());
+	for (const LevelTile& levelTile : levelTiles)
+	{
+		auto newTile = std::make_unique<Tiles>();
+		newTile->setTag(levelTile.tag);
+		newTile->setPosition(levelTile.position);
+		newTile->setSize(levelTile.size);
+		newTile->setTrigger(levelTile.trigger);
+		newTile->setStatic(levelTile.isStatic);
+		newTile->setMassless(levelTile.massless);
+		newTile->setTile(levelTile.tile);
+		if (!levelTile.textureName.empty())
+		{
+			newTile->setTextureName(levelTile.textureName);
+			sf::Texture* texture = textureManager ? textureManager->getTexture(levelTile.textureName) : nullptr;
+			if (texture)
+			{
+				newTile->setTexture(texture);
+				if (texture == textureManager->getPlaceholder())
+				{
+					chunk.awaitingTexture[levelTile.textureName].push_back(newTile.get());
+				}
+			}
+		}
+
+		if (world) world->AddGameObject(*newTile);
+		chunk.tiles.push_back(std::move(newTile));
+	}
+	tileCount += (int)chunk.tiles.size();
+	chunk.state = ChunkState::Loaded;
+}
+
+void LevelStreamer::unloadChunk(Chunk& chunk)
+{
+	if (world)
+	{
+		std::vector<GameObject*> objects;
+		objects.reserve(chunk.tiles.size());
+		for (auto& tile : chunk.tiles)
+		{
+			objects.push_back(tile.get());
+		}
+		world->RemoveGameObjects(objects);
+	}
+	tileCount -= (int)chunk.tiles.size();
+	chunk.awaitingTexture.clear();
+	chunk.tiles.clear();
+	chunk.tiles.shrink_to_fit();
+	chunk.state = ChunkState::Unloaded;
+}
+
+void LevelStreamer::applyTexture(const std::string& name, sf::Texture* texture)
+{
+	for (auto& entry : chunks)
+	{
+		auto it = entry.second.awaitingTexture.find(name);
+		if (it == entry.second.awaitingTexture.end()) continue;
+		for (Tiles* tile : it->second)
+		{
+			tile->setTexture(texture, true);
+		}
+		entry.second.awaitingTexture.erase(it);
+	}
+}
+
+// Reads chunk files one at a time. Only plain tile data crosses back to the main thread.
+void LevelStreamer::workerLoop()
+{
+	while (true)
+	{
+		LoadJob job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobAvailable.wait(lock, [this] { return stopping || !jobs.empty(); });
+			if (stopping)
+			{
+				return;
+			}
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+
+		LoadResult result;
+		result.key = job.key;
+		result.generation = job.generation;
+		LevelFile::readBinary(job.path, result.tiles);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		results.push_back(std::move(result));
+	}
+}
@@ -0,0 +1,123 @@
+// Level Streamer Class
+// Plays a level that has been split into spatial chunks on disk, keeping only the chunks near the view resident.
+// Chunk files are read on a background thread. Their tiles are created on the main thread, registered with the World,
+// and removed again once the view has moved far enough away.
+//
+// A chunk directory holds index.txt plus one binary level file (see LevelFile.h) per chunk.
+//   chunkSize,<size in pixels>
+//   chunk,<x>,<y>,<left>,<top>,<width>,<height>    one per chunk; the rect bounds every tile in the chunk
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include "Tiles.h"
+#include "World.h"
+#include "TextureManager.h"
+#include "LevelFile.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+
+class LevelStreamer
+{
+public:
+	LevelStreamer();
+	~LevelStreamer();
+
+	void setWorld(World* w) { world = w; }
+	void setTextureManager(TextureManager* tm) { textureManager = tm; }
+
+	// Split a level file (CSV or binary), plus any edits still in its journal, into square chunks written to directory with an index
+	static bool buildChunks(const std::string& levelPath, const std::string& directory, float chunkSize = 1024.f);
+	// Write tiles as chunks and rewrite the index. If only is given, just those chunk files are written, or removed if now empty.
+	static bool writeChunks(const std::vector<LevelTile>& tiles, const std::string& directory, float chunkSize,
+		const std::unordered_set<int64_t>* only = nullptr);
+	// Chunk holding a tile with these bounds: the one containing its centre
+	static int64_t getChunkKey(const sf::FloatRect& bounds, float chunkSize);
+
+	// Read a chunk directory's index. Nothing is loaded until update().
+	bool open(const std::string& directory);
+	// Unload every chunk and forget the index
+	void close();
+	bool isOpen() const { return !chunks.empty(); }
+	const std::string& getDirectory() const { return directory; }
+	float getChunkSize() const { return chunkSize; }
+
+	// Queue loads for chunks near the view, create tiles for finished loads and unload chunks that are far away
+	void update(const sf::View& view);
+
+	// Extra distance around the view to have loaded. Chunks are unloaded a further chunk beyond this.
+	void setLoadMargin(float margin) { loadMargin = margin; }
+
+	template <typename F>
+	void forEachTile(F function)
+	{
+		for (auto& chunk : chunks)
+		{
+			for (auto& tile : chunk.second.tiles)
+			{
+				function(*tile);
+			}
+		}
+	}
+
+	// Put a texture that has finished loading on the loaded tiles still showing the placeholder for it
+	void applyTexture(const std::string& name, sf::Texture* texture);
+
+	int getLoadedChunkCount() const;
+	int getTileCount() const { return tileCount; }
+
+private:
+	enum class ChunkState { Unloaded, Loading, Loaded };
+
+	struct Chunk
+	{
+		std::string path;
+		sf::FloatRect bounds;
+		ChunkState state = ChunkState::Unloaded;
+		std::vector<std::unique_ptr<Tiles>> tiles;
+		std::unordered_map<std::string, std::vector<Tiles*>> awaitingTexture; // Tiles given the placeholder, by texture name
+	};
+
+	struct LoadJob
+	{
+		int64_t key;
+		unsigned int generation;
+		std::string path;
+	};
+
+	struct LoadResult
+	{
+		int64_t key;
+		unsigned int generation;
+		std::vector<LevelTile> tiles;
+	};
+
+	static int64_t makeKey(int x, int y) { return ((int64_t)x << 32) | (uint32_t)y; }
+
+	void createTiles(Chunk& chunk, const std::vector<LevelTile>& levelTiles);
+	void unloadChunk(Chunk& chunk);
+	void workerLoop();
+
+	World* world;
+	TextureManager* textureManager;
+
+	std::string directory;
+	float chunkSize;
+	float loadMargin;
+	std::unordered_map<int64_t, Chunk> chunks;
+	int tileCount;
+	unsigned int generation; // Bumped by close() so loads for a previous index are ignored
+
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable jobAvailable;
+	std::deque<LoadJob> jobs;
+	std::deque<LoadResult> results;
+	bool stopping;
+};
@@ -0,0 +1,123 @@
+#include "MappedFile.h"
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+{
+	data = nullptr;
+	size = 0;
+#ifdef _WIN32
+	fileHandle = INVALID_HANDLE_VALUE;
+	mappingHandle = nullptr;
+#else
+	fileDescriptor = -1;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+	fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		std::cerr << "Failed to open file for mapping: " << path << std::endl;
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+	{
+		close();
+		return false;
+	}
+
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr)
+	{
+		std::cerr << "Failed to map file: " << path << std::endl;
+		close();
+		return false;
+	}
+
+	data = (const char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (data == nullptr)
+	{
+		std::cerr << "Failed to map file: " << path << std::endl;
+		close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (data != nullptr) UnmapViewOfFile(data);
+	if (mappingHandle != nullptr) CloseHandle(mappingHandle);
+	if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+	data = nullptr;
+	size = 0;
+	mappingHandle = nullptr;
+	fileHandle = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path)
+{
+	close();
+
+	fileDescriptor = ::open(path.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		std::cerr << "Failed to open file for mapping: " << path << std::endl;
+		return false;
+	}
+
+	struct stat info;
+	if (fstat(fileDescriptor, &info) != 0 || info.st_size == 0)
+	{
+		close();
+		return false;
+	}
+
+	void* mapped = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	if (mapped == MAP_FAILED)
+	{
+		std::cerr << "Failed to map file: " << path << std::endl;
+		close();
+		return false;
+	}
+	data = (const char*)mapped;
+	size = (size_t)info.st_size;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (data != nullptr) munmap((void*)data, size);
+	if (fileDescriptor >= 0) ::close(fileDescriptor);
+	data = nullptr;
+	size = 0;
+	fileDescriptor = -1;
+}
+
+#endif
@@ -0,0 +1,34 @@
+// Mapped File Class
+// Maps a whole file read-only into memory, using the Win32 file mapping API on Windows and mmap elsewhere.
+// The contents can be read in place without copying them into a buffer first.
+
+#pragma once
+#include <string>
+#include <cstddef>
+
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool open(const std::string& path);
+	void close();
+
+	bool isOpen() const { return data != nullptr; }
+	const char* getData() const { return data; }
+	size_t getSize() const { return size; }
+
+private:
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	const char* data;
+	size_t size;
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#else
+	int fileDescriptor;
+#endif
+};
@@ -0,0 +1,191 @@
+#include "MusicPlayer.h"
+#include "AssetCache.h"
+#include <iostream>
+#include <algorithm>
+
+MusicPlayer::MusicPlayer()
+{
+	current = 0;
+	volume = 100.f;
+	loop = true;
+	opened = false;
+	openSucceeded = false;
+	pendingFade = 0.f;
+}
+
+MusicPlayer::~MusicPlayer()
+{
+	if (opener.joinable())
+	{
+		opener.join();
+	}
+}
+
+void MusicPlayer::prefetch(const std::string& path)
+{
+	if (path == streams[current].path || path == streams[idle()].path || isOpening() || failedPaths.count(path))
+	{
+		return;
+	}
+	if (streams[idle()].music.getStatus() != sf::Music::Stopped)
+	{
+		return; // Still fading out, the track can be opened once it has finished
+	}
+	beginOpen(path);
+}
+
+void MusicPlayer::crossfadeTo(const std::string& path, float fadeTime)
+{
+	pendingPath.clear();
+	if (failedPaths.count(path))
+	{
+		return;
+	}
+	Stream& playing = streams[current];
+	if (path == playing.path && playing.music.getStatus() == sf::Music::Playing)
+	{
+		playing.fadeRate = fadeTime > 0.f ? 1.f / fadeTime : 1.f;
+		return;
+	}
+
+	// Either prefetched, or still fading out from the last switch and can simply fade back in
+	if (path == streams[idle()].path && !isOpening())
+	{
+		start(fadeTime);
+		return;
+	}
+
+	pendingPath = path;
+	pendingFade = fadeTime;
+	prefetch(path);
+}
+
+void MusicPlayer::stop(float fadeTime)
+{
+	pendingPath.clear();
+	for (Stream& stream : streams)
+	{
+		if (fadeTime <= 0.f)
+		{
+			stream.fade = 0.f;
+		}
+		stream.fadeRate = fadeTime > 0.f ? -1.f / fadeTime : -1.f;
+	}
+}
+
+void MusicPlayer::update(float dt)
+{
+	if (isOpening() && opened)
+	{
+		finishOpen();
+	}
+
+	if (!pendingPath.empty() && !isOpening())
+	{
+		if (pendingPath == streams[idle()].path)
+		{
+			start(pendingFade);
+			pendingPath.clear();
+		}
+		else if (streams[idle()].music.getStatus() == sf::Music::Stopped)
+		{
+			beginOpen(pendingPath);
+		}
+	}
+
+	for (int i = 0; i < 2; i++)
+	{
+		// The idle stream belongs to the opener thread while it is opening
+		if (i == idle() && isOpening())
+		{
+			continue;
+		}
+		Stream& stream = streams[i];
+		if (stream.music.getStatus() == sf::Music::Stopped)
+		{
+			continue;
+		}
+		stream.fade = std::min(1.f, std::max(0.f, stream.fade + stream.fadeRate * dt));
+		stream.music.setVolume(stream.fade * volume);
+		if (stream.fade <= 0.f && stream.fadeRate < 0.f)
+		{
+			stream.music.stop();
+		}
+	}
+}
+
+void MusicPlayer::setVolume(float v)
+{
+	volume = v;
+}
+
+void MusicPlayer::setLoop(bool l)
+{
+	loop = l;
+	for (int i = 0; i < 2; i++)
+	{
+		if (i == idle() && isOpening()) continue;
+		streams[i].music.setLoop(loop);
+	}
+}
+
+// sf::Music reads the file header and fills its first buffers on open, which is what stalls the frame
+void MusicPlayer::beginOpen(const std::string& path)
+{
+	Stream& stream = streams[idle()];
+	stream.path = path;
+	stream.fade = 0.f;
+	stream.fadeRate = 0.f;
+	opened = false;
+	opener = std::thread([this, &stream, path]
+	{
+		const char* data;
+		size_t size;
+		if (AssetCache::get().getPack().find(path, data, size))
+		{
+			openSucceeded = stream.music.openFromMemory(data, size);
+		}
+		else
+		{
+			openSucceeded = stream.music.openFromFile(path);
+		}
+		opened = true;
+	});
+}
+
+void MusicPlayer::finishOpen()
+{
+	opener.join();
+	Stream& stream = streams[idle()];
+	if (!openSucceeded)
+	{
+		std::cerr << "Failed to open music: " << stream.path << std::endl;
+		failedPaths.insert(stream.path);
+		if (pendingPath == stream.path) pendingPath.clear();
+		stream.path.clear();
+		return;
+	}
+	stream.music.setLoop(loop);
+	stream.music.setVolume(0.f);
+}
+
+// Swap streams: the idle one fades in, the playing one fades out
+void MusicPlayer::start(float fadeTime)
+{
+	float rate = fadeTime > 0.f ? 1.f / fadeTime : 1000.f;
+	Stream& next = streams[idle()];
+	Stream& previous = streams[current];
+
+	if (fadeTime <= 0.f)
+	{
+		next.fade = 1.f;
+	}
+	next.fadeRate = rate;
+	next.music.setVolume(next.fade * volume);
+	if (next.music.getStatus() != sf::Music::Playing)
+	{
+		next.music.play();
+	}
+	previous.fadeRate = -rate;
+	current = idle();
+}
@@ -0,0 +1,66 @@
+// Music Player Class
+// Plays background music on two streams so one track can fade into the next.
+// Tracks are opened on a background thread, so switching never stalls the frame. prefetch() opens the next
+// track ahead of time on the idle stream; a crossfade to a prefetched track starts on the very next update.
+// update() must be called once per frame to finish opens and move the fades along.
+
+#pragma once
+#include "SFML\Audio.hpp"
+#include <string>
+#include <thread>
+#include <atomic>
+#include <unordered_set>
+
+class MusicPlayer
+{
+public:
+	MusicPlayer();
+	~MusicPlayer();
+
+	// Open the track on the idle stream in the background, ready for a later crossfadeTo
+	void prefetch(const std::string& path);
+	// Fade the current track out and path in over fadeTime seconds. Starts once path has finished opening.
+	void crossfadeTo(const std::string& path, float fadeTime);
+	// Fade everything out
+	void stop(float fadeTime = 0.f);
+
+	void update(float dt);
+
+	void setVolume(float volume);
+	void setLoop(bool loop);
+
+	// The stream playing (or fading in) the current track
+	sf::Music* getCurrent() { return &streams[current].music; }
+	const std::string& getCurrentPath() const { return streams[current].path; }
+	bool isOpening() const { return opener.joinable(); }
+
+private:
+	struct Stream
+	{
+		sf::Music music;
+		std::string path;	// Track opened on this stream, empty if none
+		float fade = 0.f;	// 0 to 1, multiplied by the player volume
+		float fadeRate = 0.f;	// Change in fade per second, negative when fading out
+	};
+
+	int idle() const { return 1 - current; }
+	// Start opening path on the idle stream. The idle stream must be stopped and not already opening.
+	void beginOpen(const std::string& path);
+	void finishOpen();
+	void start(float fadeTime);
+
+	Stream streams[2];
+	int current;
+	float volume;
+	bool loop;
+
+	std::thread opener;
+	std::atomic<bool> opened;
+	bool openSucceeded;
+
+	// Crossfade waiting for its track to open
+	std::string pendingPath;
+	float pendingFade;
+	// Tracks that failed to open are not retried
+	std::unordered_set<std::string> failedPaths;
+};
@@ -0,0 +1,58 @@
+#include "ObjectData.h"
+#include <deque>
+#include <unordered_map>
+#include <iostream>
+
+namespace
+{
+	// Deque so references to names stay valid as more tags are added.
+	std::deque<std::string>& tagNames()
+	{
+		static std::deque<std::string> names{ "" };
+		return names;
+	}
+
+	std::unordered_map<std::string, TagId>& tagIds()
+	{
+		static std::unordered_map<std::string, TagId> ids{ { "", NoTag } };
+		return ids;
+	}
+}
+
+TagId Tags::getId(const std::string& name)
+{
+	auto it = tagIds().find(name);
+	if (it != tagIds().end())
+	{
+		return it->second;
+	}
+
+	TagId id = (TagId)tagNames().size();
+	if (id == UnknownTag)
+	{
+		std::cerr << "Too many tags, " << name << " will not be stored" << std::endl;
+		return UnknownTag;
+	}
+	tagNames().push_back(name);
+	tagIds()[name] = id;
+	return id;
+}
+
+TagId Tags::findId(const std::string& name)
+{
+	auto it = tagIds().find(name);
+	if (it != tagIds().end())
+	{
+		return it->second;
+	}
+	return UnknownTag;
+}
+
+const std::string& Tags::getName(TagId id)
+{
+	if (id >= tagNames().size())
+	{
+		return tagNames()[NoTag];
+	}
+	return tagNames()[id];
+}
@@ -0,0 +1,122 @@
+// Object Data
+// Side tables for game object data, addressed by a handle each object holds.
+// Tags are interned into small integer ids, so collision code compares numbers rather than strings.
+// PhysicsBody is the hot record: position, velocity, AABB, tags and collision flags. It is the primary storage for that
+// state, and the World's collision pass reads these records straight out of their table.
+// Cold per-object data (texture name, debug colour, render layer) lives in a second table.
+// GameObject adapts both to its existing interface, so subclasses such as Mario and Tiles use them through it.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include <string>
+#include <vector>
+
+// Interned tag. NoTag is the empty string, UnknownTag is returned when looking up a name that was never used.
+typedef unsigned short TagId;
+const TagId NoTag = 0;
+const TagId UnknownTag = 0xFFFF;
+
+// Static class, stores every tag name once and maps it to a TagId.
+class Tags
+{
+public:
+	// Returns the id for the name, adding it if this is the first time it has been seen.
+	static TagId getId(const std::string& name);
+	// Returns the id for the name without adding it. UnknownTag if no object has used it.
+	static TagId findId(const std::string& name);
+	// Returns the name for an id. The reference stays valid for the lifetime of the program.
+	static const std::string& getName(TagId id);
+};
+
+// Handle into an object data table.
+typedef unsigned int ObjectHandle;
+
+// Hot record used by the physics step and the World's collision pass. One per object, stored contiguously.
+struct PhysicsBody
+{
+	enum Flags : unsigned char { STATIC = 1, TRIGGER = 2, TILE = 4, MASSLESS = 8 };
+
+	sf::Vector2f position;
+	sf::Vector2f velocity;
+	sf::FloatRect aabb;
+	TagId tag = NoTag;
+	TagId collidingTag = NoTag; // Tag of what the object touched this step
+	unsigned char flags = 0;
+};
+
+// Per-object data only needed for rendering, debugging and saving.
+struct ObjectColdData
+{
+	std::string textureName;
+	sf::Color debugColor = sf::Color::Red;
+	int renderLayer = 0;
+};
+
+// Static class, owns one record of type T for every game object. Released slots are reused.
+template <typename T>
+class ObjectTable
+{
+public:
+	static ObjectHandle create()
+	{
+		if (!freeHandles().empty())
+		{
+			ObjectHandle handle = freeHandles().back();
+			freeHandles().pop_back();
+			return handle;
+		}
+		records().emplace_back();
+		return (ObjectHandle)records().size() - 1;
+	}
+	// The record is reset, so a released slot holds no strings or stale state
+	static void destroy(ObjectHandle handle)
+	{
+		records()[handle] = T();
+		freeHandles().push_back(handle);
+	}
+	// References are invalidated by the next create(), so don't hold on to them.
+	static T& get(ObjectHandle handle) { return records()[handle]; }
+	static int getCount() { return (int)(records().size() - freeHandles().size()); }
+
+private:
+	static std::vector<T>& records()
+	{
+		static std::vector<T> table;
+		return table;
+	}
+	static std::vector<ObjectHandle>& freeHandles()
+	{
+		static std::vector<ObjectHandle> handles;
+		return handles;
+	}
+};
+
+// Owning reference to a record. Copying it copies the record into a new slot, so copied objects don't share data.
+template <typename T>
+class ObjectRef
+{
+public:
+	ObjectRef() { handle = ObjectTable<T>::create(); }
+	ObjectRef(const ObjectRef& other)
+	{
+		handle = ObjectTable<T>::create();
+		ObjectTable<T>::get(handle) = ObjectTable<T>::get(other.handle);
+	}
+	ObjectRef& operator=(const ObjectRef& other)
+	{
+		if (this != &other) ObjectTable<T>::get(handle) = ObjectTable<T>::get(other.handle);
+		return *this;
+	}
+	~ObjectRef() { ObjectTable<T>::destroy(handle); }
+
+	T& get() const { return ObjectTable<T>::get(handle); }
+	ObjectHandle getHandle() const { return handle; }
+
+private:
+	ObjectHandle handle;
+};
+
+typedef ObjectTable<PhysicsBody> PhysicsBodyTable;
+typedef ObjectRef<PhysicsBody> PhysicsBodyRef;
+typedef ObjectTable<ObjectColdData> ObjectDataTable;
+typedef ObjectRef<ObjectColdData> ObjectColdRef;
@@ -0,0 +1,94 @@
+#include "RecordingRenderBackend.h"
+
+RecordingRenderBackend::RecordingRenderBackend(sf::Vector2u targetSize)
+{
+	size = targetSize;
+	view.reset(sf::FloatRect(0.f, 0.f, (float)size.x, (float)size.y));
+	reset();
+}
+
+void RecordingRenderBackend::reset()
+{
+	stats = Stats();
+	drawCalls.clear();
+	lastTexture = nullptr;
+	lastShader = nullptr;
+	lastBlendMode = sf::BlendAlpha;
+	hasDrawn = false;
+}
+
+void RecordingRenderBackend::setView(const sf::View& v)
+{
+	view = v;
+	stats.viewChanges++;
+}
+
+// Work out the draw calls SFML would make for the standard drawables, without touching OpenGL.
+// Anything unrecognised is counted as a single draw call with no vertices.
+void RecordingRenderBackend::draw(const sf::Drawable& drawable, const sf::RenderStates& states)
+{
+	if (auto sprite = dynamic_cast<const sf::Sprite*>(&drawable))
+	{
+		record(sf::TriangleStrip, 4, sprite->getTexture(), states);
+	}
+	else if (auto shape = dynamic_cast<const sf::Shape*>(&drawable))
+	{
+		record(sf::TriangleFan, shape->getPointCount() + 2, shape->getTexture(), states);
+		if (shape->getOutlineThickness() != 0)
+		{
+			record(sf::TriangleStrip, (shape->getPointCount() + 1) * 2, nullptr, states);
+		}
+	}
+	else if (auto text = dynamic_cast<const sf::Text*>(&drawable))
+	{
+		// Six vertices per visible glyph, drawn from the font's glyph page
+		std::size_t glyphs = 0;
+		for (sf::Uint32 c : text->getString())
+		{
+			if (c != ' ' && c != '\t' && c != '\n') glyphs++;
+		}
+		if (text->getOutlineThickness() != 0)
+		{
+			record(sf::Triangles, glyphs * 6, text->getFont(), states);
+		}
+		record(sf::Triangles, glyphs * 6, text->getFont(), states);
+	}
+	else if (auto array = dynamic_cast<const sf::VertexArray*>(&drawable))
+	{
+		record(array->getPrimitiveType(), array->getVertexCount(), states.texture, states);
+	}
+	else if (auto buffer = dynamic_cast<const sf::VertexBuffer*>(&drawable))
+	{
+		record(buffer->getPrimitiveType(), buffer->getVertexCount(), states.texture, states);
+	}
+	else
+	{
+		record(sf::Points, 0, states.texture, states);
+	}
+}
+
+void RecordingRenderBackend::draw(const sf::Vertex* vertices, std::size_t vertexCount, sf::PrimitiveType type, const sf::RenderStates& states)
+{
+	if (!vertices || vertexCount == 0) return;
+	record(type, vertexCount, states.texture, states);
+}
+
+void RecordingRenderBackend::record(sf::PrimitiveType type, std::size_t vertexCount, const void* texture, const sf::RenderStates& states)
+{
+	drawCalls.push_back({ type, vertexCount, texture, states.shader, states.blendMode });
+	stats.drawCalls++;
+	stats.vertices += (int)vertexCount;
+
+	if (!hasDrawn || texture != lastTexture)
+	{
+		if (texture) stats.textureBinds++;
+		lastTexture = texture;
+	}
+	if (hasDrawn && (states.shader != lastShader || states.blendMode != lastBlendMode))
+	{
+		stats.stateChanges++;
+	}
+	lastShader = states.shader;
+	lastBlendMode = states.blendMode;
+	hasDrawn = true;
+}
@@ -0,0 +1,61 @@
+// Recording Render Backend Class
+// Render backend that records what would be drawn instead of drawing it. No window or GPU is needed.
+// Counts draw calls, vertices, texture binds and state changes, so batching and culling can be measured headlessly.
+
+#pragma once
+#include "RenderBackend.h"
+#include <vector>
+
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+	// A single recorded draw call. Texture identifies what would be bound (a font for text, null for untextured).
+	struct DrawCall
+	{
+		sf::PrimitiveType type;
+		std::size_t vertexCount;
+		const void* texture;
+		const sf::Shader* shader;
+		sf::BlendMode blendMode;
+	};
+
+	// Totals since the last reset.
+	struct Stats
+	{
+		int drawCalls = 0;
+		int vertices = 0;
+		int textureBinds = 0;
+		int stateChanges = 0;
+		int viewChanges = 0;
+	};
+
+	RecordingRenderBackend(sf::Vector2u targetSize);
+
+	void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default) override;
+	void draw(const sf::Vertex* vertices, std::size_t vertexCount, sf::PrimitiveType type, const sf::RenderStates& states = sf::RenderStates::Default) override;
+
+	void setView(const sf::View& v) override;
+	const sf::View& getView() const override { return view; }
+	sf::Vector2u getSize() const override { return size; }
+	bool supportsRenderTextures() const override { return false; }
+
+	// Clear the recording, e.g. at the start of each frame being measured.
+	void reset();
+
+	const Stats& getStats() const { return stats; }
+	const std::vector<DrawCall>& getDrawCalls() const { return drawCalls; }
+
+private:
+	void record(sf::PrimitiveType type, std::size_t vertexCount, const void* texture, const sf::RenderStates& states);
+
+	sf::Vector2u size;
+	sf::View view;
+	Stats stats;
+	std::vector<DrawCall> drawCalls;
+
+	// State of the previous draw call, to detect binds and changes
+	const void* lastTexture;
+	const sf::Shader* lastShader;
+	sf::BlendMode lastBlendMode;
+	bool hasDrawn;
+};
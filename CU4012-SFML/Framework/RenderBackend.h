@@ -0,0 +1,45 @@
+// Render Backend Classes
+// Abstract render target the level, menu and tile rendering code draws through.
+// SFMLRenderBackend forwards to an sf::RenderTarget (normally the window).
+// See RecordingRenderBackend for a backend that records draw calls without a GPU.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() {}
+
+	// Draw a drawable object (sprite, shape, text, vertex array...).
+	virtual void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default) = 0;
+	// Draw primitives defined by an array of vertices.
+	virtual void draw(const sf::Vertex* vertices, std::size_t vertexCount, sf::PrimitiveType type, const sf::RenderStates& states = sf::RenderStates::Default) = 0;
+
+	// Current view, used for culling and positioning.
+	virtual void setView(const sf::View& view) = 0;
+	virtual const sf::View& getView() const = 0;
+	// Size of the render target in pixels.
+	virtual sf::Vector2u getSize() const = 0;
+	// False if there is no GPU behind the backend. Anything needing one, like the static layer's render textures, is then skipped.
+	virtual bool supportsRenderTextures() const { return true; }
+};
+
+// Forwards everything to an SFML render target.
+class SFMLRenderBackend : public RenderBackend
+{
+public:
+	SFMLRenderBackend(sf::RenderTarget* t) { target = t; }
+
+	void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default) override { target->draw(drawable, states); }
+	void draw(const sf::Vertex* vertices, std::size_t vertexCount, sf::PrimitiveType type, const sf::RenderStates& states = sf::RenderStates::Default) override { target->draw(vertices, vertexCount, type, states); }
+
+	void setView(const sf::View& view) override { target->setView(view); }
+	const sf::View& getView() const override { return target->getView(); }
+	sf::Vector2u getSize() const override { return target->getSize(); }
+
+	sf::RenderTarget* getTarget() { return target; }
+
+private:
+	sf::RenderTarget* target;
+};
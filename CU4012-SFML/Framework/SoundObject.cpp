@@ -1,22 +1,63 @@
 #include "SoundObject.h"
+#include "AssetCache.h"
 
 SoundObject::SoundObject()
 {
-	buffer = nullptr;
+	maxInstances = 4;
+	priority = 0;
+	mode = AudioLoadMode::Preload;
+	pcmBytes = 0;
+	loadFailed = false;
 }
 
 SoundObject::~SoundObject()
 {
-	delete buffer;
-	buffer = nullptr;
+	// The sound detaches from its buffer when destroyed, so it has to let go before the buffer can
+	sound.resetBuffer();
 }
 
 // Loads sound into memory and can be identified by key (name).
 // Receives filepath and key name, loads sound file and stores alonside key
-void SoundObject::loadSound(std::string filename, std::string lname)
+void SoundObject::loadSound(std::string lfilename, std::string lname, AudioLoadMode lmode)
 {
-	buffer = new sf::SoundBuffer();
-	buffer->loadFromFile(filename);
-	sound.setBuffer(*buffer);
+	filename = lfilename;
 	name = lname;
+	mode = lmode;
+
+	if (mode == AudioLoadMode::Preload)
+	{
+		makeResident();
+	}
+	else if (mode == AudioLoadMode::Stream)
+	{
+		// Packed sounds stream straight out of the pack mapping
+		stream = std::make_shared<sf::Music>();
+		const char* data;
+		size_t size;
+		bool opened = AssetCache::get().getPack().find(filename, data, size)
+			? stream->openFromMemory(data, size) : stream->openFromFile(filename);
+		if (!opened)
+		{
+			std::cerr << "Failed to open sound stream: " << filename << std::endl;
+			stream = nullptr;
+		}
+	}
+}
+
+void SoundObject::makeResident()
+{
+	if (buffer || loadFailed || mode == AudioLoadMode::Stream)
+	{
+		return;
+	}
+	buffer = AssetCache::get().getSoundBuffer(filename);
+	if (buffer)
+	{
+		sound.setBuffer(*buffer);
+		pcmBytes = (size_t)buffer->getSampleCount() * sizeof(sf::Int16);
+	}
+	else
+	{
+		loadFailed = true;
+	}
 }
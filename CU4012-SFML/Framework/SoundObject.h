@@ -1,9 +1,18 @@
 // Sound object
 // Loads a sound file and stores related key.
 // Key is used to find specific sounds for playback
+// How the file is held in memory is chosen per sound by AudioManager's load policy, see AudioLoadMode.
 
 #pragma once
 #include "SFML\Audio.hpp"
+#include <memory>
+
+enum class AudioLoadMode
+{
+	Preload,	// Decoded into memory when added
+	Lazy,		// Decoded into memory the first time it is played
+	Stream		// Never decoded as a whole, played from the file like music
+};
 
 class SoundObject
 {
@@ -12,14 +21,27 @@ public:
 	~SoundObject();
 
 	// Receives filepath and key name, loads sound file and stores alonside key
-	void loadSound(std::string filename, std::string lname);
+	void loadSound(std::string filename, std::string lname, AudioLoadMode mode = AudioLoadMode::Preload);
+	// Decode a lazily loaded sound now. Does nothing if it is already resident or streamed.
+	void makeResident();
+	bool isResident() const { return buffer != nullptr; }
 
 	// Sound and key variables. (shouldn't be public)
 	sf::Sound sound;
 	std::string name;
+	std::string filename;
+	// Voice pool limits, see AudioManager::addSound
+	int maxInstances;
+	int priority;
+	AudioLoadMode mode;
+	// Decoded size in bytes, whether or not it is resident
+	size_t pcmBytes;
+	// Open stream for Stream sounds, nullptr otherwise. Shared so the object stays copyable.
+	std::shared_ptr<sf::Music> stream;
 private:
-	// Sound buffer must not leave scope or sound will be destroyed.
-	sf::SoundBuffer* buffer;
-	
-};
+	// Sound buffer must not leave scope or sound will be destroyed. Shared through the AssetCache, so
+	// every sound using the same file shares one buffer and copies of the object keep it alive.
+	std::shared_ptr<sf::SoundBuffer> buffer;
+	bool loadFailed; // Not retried on every play
 
+};
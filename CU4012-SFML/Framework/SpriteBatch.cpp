@@ -0,0 +1,76 @@
+#include "SpriteBatch.h"
+#include "GameObject.h"
+#include <algorithm>
+
+SpriteBatch::SpriteBatch()
+{
+	drawCalls = 0;
+	quadCount = 0;
+}
+
+// Discard everything submitted since the last flush.
+void SpriteBatch::begin()
+{
+	keys.clear();
+	corners.clear();
+}
+
+// Transform the four corners of the quad once, on submission, so flushing only has to copy vertices.
+void SpriteBatch::submit(const sf::Texture* texture, const sf::IntRect& textureRect, const sf::Transform& transform, sf::Vector2f size, sf::Color color, int layer)
+{
+	float left = (float)textureRect.left;
+	float top = (float)textureRect.top;
+	float right = left + textureRect.width;
+	float bottom = top + textureRect.height;
+
+	keys.push_back({ layer, texture, (unsigned int)keys.size() });
+	corners.push_back(sf::Vertex(transform.transformPoint(0.f, 0.f), color, sf::Vector2f(left, top)));
+	corners.push_back(sf::Vertex(transform.transformPoint(size.x, 0.f), color, sf::Vector2f(right, top)));
+	corners.push_back(sf::Vertex(transform.transformPoint(size.x, size.y), color, sf::Vector2f(right, bottom)));
+	corners.push_back(sf::Vertex(transform.transformPoint(0.f, size.y), color, sf::Vector2f(left, bottom)));
+}
+
+void SpriteBatch::submit(const GameObject& object)
+{
+	submit(object.getTexture(), object.getTextureRect(), object.getTransform(), object.getSize(), object.getFillColor(), object.getRenderLayer());
+}
+
+// Sort by layer then texture, and issue one draw call for every run of quads that share a texture.
+void SpriteBatch::flush(RenderBackend& target, sf::RenderStates states)
+{
+	drawCalls = 0;
+	quadCount = (int)keys.size();
+
+	std::sort(keys.begin(), keys.end(), [](const SortKey& a, const SortKey& b)
+		{
+			if (a.layer != b.layer) return a.layer < b.layer;
+			if (a.texture != b.texture) return std::less<const sf::Texture*>()(a.texture, b.texture);
+			return a.index < b.index;
+		});
+
+	vertices.clear();
+	vertices.reserve(keys.size() * 6);
+
+	size_t runStart = 0;
+	for (size_t i = 0; i < keys.size(); i++)
+	{
+		const sf::Vertex* quad = &corners[keys[i].index * 4];
+		vertices.push_back(quad[0]);
+		vertices.push_back(quad[1]);
+		vertices.push_back(quad[2]);
+		vertices.push_back(quad[0]);
+		vertices.push_back(quad[2]);
+		vertices.push_back(quad[3]);
+
+		// Flush the run when the next quad uses a different texture, or when this is the last quad
+		if (i + 1 == keys.size() || keys[i + 1].texture != keys[i].texture)
+		{
+			states.texture = keys[i].texture;
+			target.draw(&vertices[runStart], vertices.size() - runStart, sf::Triangles, states);
+			runStart = vertices.size();
+			drawCalls++;
+		}
+	}
+
+	begin();
+}
@@ -0,0 +1,49 @@
+// Sprite Batch Class
+// Collects the textured quads submitted by game objects during a frame and draws them with as few draw calls as possible.
+// Quads are sorted by layer, then by texture. Every run of quads sharing a texture is flushed as a single vertex array.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include "RenderBackend.h"
+#include <vector>
+
+class GameObject;
+
+class SpriteBatch
+{
+public:
+	SpriteBatch();
+
+	// Discard everything submitted since the last flush.
+	void begin();
+
+	// Submit a quad of the given local size, placed by the transform. A null texture draws a solid quad of the given colour.
+	void submit(const sf::Texture* texture, const sf::IntRect& textureRect, const sf::Transform& transform, sf::Vector2f size, sf::Color color, int layer);
+	// Submit a game object using its texture, texture rect, transform, size, fill colour and render layer.
+	void submit(const GameObject& object);
+
+	// Sort the submitted quads and draw them to the target, then empty the batch ready for the next frame.
+	void flush(RenderBackend& target, sf::RenderStates states = sf::RenderStates::Default);
+
+	// Statistics from the last flush, useful for profiling.
+	int getDrawCallCount() const { return drawCalls; }
+	int getQuadCount() const { return quadCount; }
+
+private:
+	// Sort key for a submitted quad. Index is the submission order, so quads that compare equal keep their order.
+	struct SortKey
+	{
+		int layer;
+		const sf::Texture* texture;
+		unsigned int index;
+	};
+
+	std::vector<SortKey> keys;
+	// Four corners per submitted quad, in submission order.
+	std::vector<sf::Vertex> corners;
+	// Triangle list built in sorted order during flush. Kept between frames so its memory is reused.
+	std::vector<sf::Vertex> vertices;
+
+	int drawCalls;
+	int quadCount;
+};
@@ -0,0 +1,127 @@
+#include "SpriteSheet.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include "AssetCache.h"
+
+SpriteSheet::SpriteSheet()
+{
+}
+
+bool SpriteSheet::loadFromFile(const std::string& filePath)
+{
+	path = filePath;
+	clips.clear();
+	textureFile.clear();
+
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		std::cerr << "Failed to open sprite sheet: " << path << std::endl;
+		return false;
+	}
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		if (line.empty() || line[0] == '#') continue;
+		if (!parseLine(line, lineNumber))
+		{
+			return false;
+		}
+	}
+
+	if (textureFile.empty())
+	{
+		std::cerr << "Sprite sheet " << path << " has no texture" << std::endl;
+		return false;
+	}
+
+	// Texture is relative to the descriptor
+	std::string directory;
+	size_t slash = path.find_last_of("/\\");
+	if (slash != std::string::npos)
+	{
+		directory = path.substr(0, slash + 1);
+	}
+	texture = AssetCache::get().getTexture(directory + textureFile);
+	if (!texture)
+	{
+		return false;
+	}
+
+	for (AnimationClip& clip : clips)
+	{
+		clip.texture = texture.get();
+	}
+	return true;
+}
+
+void SpriteSheet::registerClips(AnimationSystem& animations) const
+{
+	for (const AnimationClip& clip : clips)
+	{
+		if (animations.addClip(clip) == InvalidClip)
+		{
+			std::cerr << "Skipped clip " << clip.name << " from sprite sheet " << path << std::endl;
+		}
+	}
+}
+
+bool SpriteSheet::parseLine(const std::string& line, int lineNumber)
+{
+	std::stringstream linestream(line);
+	std::string segment;
+	std::vector<std::string> seglist;
+	while (std::getline(linestream, segment, ','))
+	{
+		seglist.push_back(segment);
+	}
+
+	try
+	{
+		if (seglist[0] == "texture" && seglist.size() >= 2)
+		{
+			textureFile = seglist[1];
+			return true;
+		}
+		if (seglist[0] == "clip" && seglist.size() >= 3)
+		{
+			AnimationClip clip;
+			clip.name = seglist[1];
+			clip.frameDuration = std::stof(seglist[2]);
+			if (seglist.size() >= 4 && !parseLoopMode(seglist[3], clip.mode))
+			{
+				std::cerr << path << ":" << lineNumber << " unknown loop mode " << seglist[3] << std::endl;
+				return false;
+			}
+			clips.push_back(clip);
+			return true;
+		}
+		if (seglist[0] == "frame" && seglist.size() >= 5 && !clips.empty())
+		{
+			AnimationClip& clip = clips.back();
+			clip.frames.push_back(sf::IntRect(std::stoi(seglist[1]), std::stoi(seglist[2]), std::stoi(seglist[3]), std::stoi(seglist[4])));
+			clip.durations.push_back(seglist.size() >= 6 ? std::stof(seglist[5]) : clip.frameDuration);
+			return true;
+		}
+	}
+	catch (const std::exception&)
+	{
+	}
+
+	std::cerr << path << ":" << lineNumber << " could not parse: " << line << std::endl;
+	return false;
+}
+
+bool SpriteSheet::parseLoopMode(const std::string& text, LoopMode& mode)
+{
+	if (text == "loop") mode = LoopMode::Loop;
+	else if (text == "once") mode = LoopMode::Once;
+	else if (text == "pingpong") mode = LoopMode::PingPong;
+	else return false;
+	return true;
+}
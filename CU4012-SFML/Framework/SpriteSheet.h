@@ -0,0 +1,39 @@
+// Sprite Sheet Class
+// Loads a sprite sheet descriptor: the sheet texture plus named clips made of frame rects.
+// Frames stay in texture pixels, which is what SpriteBatch and sf::Vertex texture coordinates use.
+//
+// Descriptor format, one entry per line, comma separated. Lines starting with # are comments.
+//   texture,<file name, relative to the descriptor>
+//   clip,<name>,<frame duration in seconds>,<loop|once|pingpong>
+//   frame,<left>,<top>,<width>,<height>[,<duration override>]
+// Frames belong to the most recent clip.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include "AnimationSystem.h"
+#include <string>
+#include <vector>
+#include <memory>
+
+class SpriteSheet
+{
+public:
+	SpriteSheet();
+
+	bool loadFromFile(const std::string& path);
+	// Adds every clip in the sheet to the animation system. Clips whose name another sheet already uses are reported and skipped.
+	void registerClips(AnimationSystem& animations) const;
+
+	const sf::Texture* getTexture() const { return texture.get(); }
+	const std::string& getPath() const { return path; }
+	int getClipCount() const { return (int)clips.size(); }
+
+private:
+	bool parseLine(const std::string& line, int lineNumber);
+	static bool parseLoopMode(const std::string& text, LoopMode& mode);
+
+	std::string path;
+	std::string textureFile;
+	std::shared_ptr<sf::Texture> texture;
+	std::vector<AnimationClip> clips;
+};
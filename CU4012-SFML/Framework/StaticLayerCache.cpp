@@ -0,0 +1,187 @@
+#include "StaticLayerCache.h"
+#include <cmath>
+#include <iostream>
+
+StaticLayerCache::StaticLayerCache()
+{
+	origin = sf::Vector2f(0, 0);
+	columns = 0;
+	rows = 0;
+	cellSize = 512;
+	layoutDirty = true;
+	anyDirty = true;
+	available = true;
+}
+
+void StaticLayerCache::setCellSize(unsigned int size)
+{
+	if (size > 0 && size != cellSize)
+	{
+		cellSize = size;
+		layoutDirty = true;
+	}
+}
+
+// Flag every cell overlapping the area. Areas outside the current grid force the grid to be rebuilt.
+void StaticLayerCache::markDirty(const sf::FloatRect& area)
+{
+	if (layoutDirty) return;
+
+	sf::FloatRect bounds(origin.x, origin.y, (float)columns * cellSize, (float)rows * cellSize);
+	if (area.left < bounds.left || area.top < bounds.top ||
+		area.left + area.width > bounds.left + bounds.width || area.top + area.height > bounds.top + bounds.height)
+	{
+		layoutDirty = true;
+		return;
+	}
+
+	int firstColumn = std::max(0, (int)std::floor((area.left - origin.x) / cellSize));
+	int lastColumn = std::min(columns - 1, (int)std::floor((area.left + area.width - origin.x) / cellSize));
+	int firstRow = std::max(0, (int)std::floor((area.top - origin.y) / cellSize));
+	int lastRow = std::min(rows - 1, (int)std::floor((area.top + area.height - origin.y) / cellSize));
+
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		for (int column = firstColumn; column <= lastColumn; column++)
+		{
+			cells[row * columns + column].dirty = true;
+			anyDirty = true;
+		}
+	}
+}
+
+sf::FloatRect StaticLayerCache::getCellRect(int column, int row) const
+{
+	return sf::FloatRect(origin.x + (float)column * cellSize, origin.y + (float)row * cellSize, (float)cellSize, (float)cellSize);
+}
+
+// Size the grid to cover every cached tile. Existing textures are dropped and all cells start dirty.
+void StaticLayerCache::rebuildLayout(const std::vector<std::unique_ptr<Tiles>>& tiles)
+{
+	bool first = true;
+	sf::FloatRect bounds;
+	for (auto& tile : tiles)
+	{
+		if (!tile || !isCached(*tile)) continue;
+
+		sf::FloatRect b = tile->getGlobalBounds();
+		if (first)
+		{
+			bounds = b;
+			first = false;
+		}
+		else
+		{
+			float right = std::max(bounds.left + bounds.width, b.left + b.width);
+			float bottom = std::max(bounds.top + bounds.height, b.top + b.height);
+			bounds.left = std::min(bounds.left, b.left);
+			bounds.top = std::min(bounds.top, b.top);
+			bounds.width = right - bounds.left;
+			bounds.height = bottom - bounds.top;
+		}
+	}
+
+	cells.clear();
+	columns = 0;
+	rows = 0;
+	if (!first)
+	{
+		origin.x = std::floor(bounds.left / cellSize) * cellSize;
+		origin.y = std::floor(bounds.top / cellSize) * cellSize;
+		columns = (int)std::floor((bounds.left + bounds.width - origin.x) / cellSize) + 1;
+		rows = (int)std::floor((bounds.top + bounds.height - origin.y) / cellSize) + 1;
+		cells.resize((size_t)columns * rows);
+	}
+
+	layoutDirty = false;
+	anyDirty = !cells.empty();
+}
+
+// Create the cell's texture on first use and clear it ready for drawing.
+bool StaticLayerCache::prepareCell(Cell& cell, int column, int row)
+{
+	if (!cell.texture)
+	{
+		cell.texture = std::make_unique<sf::RenderTexture>();
+		if (!cell.texture->create(cellSize, cellSize))
+		{
+			std::cerr << "Failed to create static layer texture, drawing static tiles directly." << std::endl;
+			cell.texture.reset();
+			available = false;
+			return false;
+		}
+	}
+
+	sf::FloatRect rect = getCellRect(column, row);
+	cell.texture->setView(sf::View(rect));
+	cell.texture->clear(sf::Color::Transparent);
+	cell.sprite.setTexture(cell.texture->getTexture(), true);
+	cell.sprite.setPosition(rect.left, rect.top);
+	cell.hasContent = true;
+	return true;
+}
+
+// Re-render dirty cells. Tiles are visited once and drawn into every dirty cell they overlap.
+void StaticLayerCache::update(const std::vector<std::unique_ptr<Tiles>>& tiles)
+{
+	if (!available) return;
+	if (layoutDirty) rebuildLayout(tiles);
+	if (!anyDirty) return;
+
+	for (auto& cell : cells)
+	{
+		if (cell.dirty) cell.hasContent = false;
+	}
+
+	for (auto& tile : tiles)
+	{
+		if (!tile || !isCached(*tile) || tile->getTexture() == nullptr) continue;
+
+		sf::FloatRect b = tile->getGlobalBounds();
+		int firstColumn = std::max(0, (int)std::floor((b.left - origin.x) / cellSize));
+		int lastColumn = std::min(columns - 1, (int)std::floor((b.left + b.width - origin.x) / cellSize));
+		int firstRow = std::max(0, (int)std::floor((b.top - origin.y) / cellSize));
+		int lastRow = std::min(rows - 1, (int)std::floor((b.top + b.height - origin.y) / cellSize));
+
+		for (int row = firstRow; row <= lastRow; row++)
+		{
+			for (int column = firstColumn; column <= lastColumn; column++)
+			{
+				Cell& cell = cells[row * columns + column];
+				if (!cell.dirty) continue;
+				if (!cell.hasContent && !prepareCell(cell, column, row)) return;
+				cell.texture->draw(*tile);
+			}
+		}
+	}
+
+	for (auto& cell : cells)
+	{
+		if (cell.dirty && cell.hasContent) cell.texture->display();
+		cell.dirty = false;
+	}
+	anyDirty = false;
+}
+
+// Composite the cells in view. Each one is a single textured quad.
+void StaticLayerCache::render(RenderBackend& target)
+{
+	if (!available || cells.empty()) return;
+
+	const sf::View& view = target.getView();
+	sf::FloatRect visible(view.getCenter() - view.getSize() / 2.f, view.getSize());
+
+	int firstColumn = std::max(0, (int)std::floor((visible.left - origin.x) / cellSize));
+	int lastColumn = std::min(columns - 1, (int)std::floor((visible.left + visible.width - origin.x) / cellSize));
+	int firstRow = std::max(0, (int)std::floor((visible.top - origin.y) / cellSize));
+	int lastRow = std::min(rows - 1, (int)std::floor((visible.top + visible.height - origin.y) / cellSize));
+
+	for (int row = firstRow; row <= lastRow; row++)
+	{
+		for (int column = firstColumn; column <= lastColumn; column++)
+		{
+			const Cell& cell = cells[row * columns + column];
+			if (cell.hasContent) target.draw(cell.sprite);
+		}
+	}
+}
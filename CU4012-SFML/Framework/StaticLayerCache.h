@@ -0,0 +1,58 @@
+// Static Layer Cache Class
+// Renders static tiles into a grid of off-screen textures (cells) covering the level.
+// Each frame only the cells in view are drawn, one textured quad each, instead of every static tile.
+// A cell is only re-rendered after something inside it has been marked dirty, e.g. by the tile editor.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include "Tiles.h"
+#include "RenderBackend.h"
+#include <vector>
+#include <memory>
+
+class StaticLayerCache
+{
+public:
+	StaticLayerCache();
+
+	// Size in pixels of each square cell. Changing it rebuilds the whole cache.
+	void setCellSize(unsigned int size);
+
+	// Mark an area of the level as changed. Overlapping cells are re-rendered on the next update.
+	void markDirty(const sf::FloatRect& area);
+	// Rebuild the grid around the current level bounds and re-render every cell.
+	void markAllDirty() { layoutDirty = true; }
+
+	// Re-render any dirty cells from the static tiles in the list.
+	void update(const std::vector<std::unique_ptr<Tiles>>& tiles);
+	// Draw the cells overlapping the target's current view.
+	void render(RenderBackend& target);
+
+	// False if render textures could not be created. Static tiles must then be drawn directly.
+	bool isAvailable() const { return available; }
+	// Tiles that are drawn into the cache rather than every frame.
+	static bool isCached(Tiles& tile) { return tile.getStatic(); }
+
+private:
+	struct Cell
+	{
+		std::unique_ptr<sf::RenderTexture> texture;
+		sf::Sprite sprite;
+		bool dirty = true;
+		bool hasContent = false;
+	};
+
+	void rebuildLayout(const std::vector<std::unique_ptr<Tiles>>& tiles);
+	sf::FloatRect getCellRect(int column, int row) const;
+	bool prepareCell(Cell& cell, int column, int row);
+
+	std::vector<Cell> cells;
+	sf::Vector2f origin;
+	int columns;
+	int rows;
+	unsigned int cellSize;
+
+	bool layoutDirty;
+	bool anyDirty;
+	bool available;
+};
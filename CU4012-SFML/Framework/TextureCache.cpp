@@ -0,0 +1,295 @@
+#include "TextureCache.h"
+#include "AssetCache.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	const uint32_t TextureCacheMagic = 0x43584554; // "TEXC"
+	const uint32_t TextureCacheVersion = 1;
+}
+
+TextureCache::TextureCache()
+{
+	entries = nullptr;
+	entryCount = 0;
+	dirty = false;
+	saveDone = false;
+	saveSucceeded = false;
+	hits = 0;
+	misses = 0;
+}
+
+TextureCache::~TextureCache()
+{
+	wait();
+}
+
+bool TextureCache::open(const std::string& path)
+{
+	wait(); // A running save reads from the current mapping
+	file.close();
+	entries = nullptr;
+	entryCount = 0;
+	entryIndices.clear();
+	cachePath = path;
+
+	if (!fs::exists(path))
+	{
+		return true;
+	}
+	if (!file.open(path))
+	{
+		return false;
+	}
+
+	const FileHeader* header = (const FileHeader*)file.getData();
+	if (file.getSize() < sizeof(FileHeader) || header->magic != TextureCacheMagic || header->version != TextureCacheVersion
+		|| sizeof(FileHeader) + (uint64_t)header->entryCount * sizeof(FileEntry) > file.getSize())
+	{
+		std::cout << "Texture cache " << path << " is out of date and will be rebuilt" << std::endl;
+		file.close();
+		dirty = true;
+		return true;
+	}
+
+	entries = (const FileEntry*)(file.getData() + sizeof(FileHeader));
+	entryCount = header->entryCount;
+	for (uint32_t i = 0; i < entryCount; i++)
+	{
+		const FileEntry& entry = entries[i];
+		if (header->stringDataOffset + (uint64_t)entry.pathOffset + entry.pathLength > file.getSize()
+			|| entry.pixelOffset + (uint64_t)entry.width * entry.height * 4 > file.getSize())
+		{
+			continue;
+		}
+		std::string key(file.getData() + header->stringDataOffset + entry.pathOffset, entry.pathLength);
+		entryIndices[key] = i;
+	}
+	return true;
+}
+
+TextureCache::SourceInfo TextureCache::describeSource(const std::string& sourcePath)
+{
+	SourceInfo info;
+	info.key = AssetCache::canonicalPath(sourcePath);
+
+	// Packed images are loaded in preference to loose files, so they are keyed by the pack instead
+	const AssetPack& pack = AssetCache::get().getPack();
+	const char* data;
+	size_t size;
+	if (pack.find(sourcePath, data, size))
+	{
+		info.fileSize = size;
+		info.modifiedTime = pack.getModifiedTime();
+		info.exists = true;
+		return info;
+	}
+
+	std::error_code error;
+	info.fileSize = fs::file_size(sourcePath, error);
+	if (error) return info;
+	info.modifiedTime = (int64_t)fs::last_write_time(sourcePath, error).time_since_epoch().count();
+	info.exists = !error;
+	return info;
+}
+
+const TextureCache::FileEntry* TextureCache::findCurrent(const SourceInfo& source) const
+{
+	if (!source.exists) return nullptr;
+	auto it = entryIndices.find(source.key);
+	if (it == entryIndices.end()) return nullptr;
+
+	const FileEntry& entry = entries[it->second];
+	if (entry.fileSize != source.fileSize || entry.modifiedTime != source.modifiedTime)
+	{
+		return nullptr;
+	}
+	return &entry;
+}
+
+bool TextureCache::contains(const std::string& sourcePath)
+{
+	return findCurrent(describeSource(sourcePath)) != nullptr;
+}
+
+bool TextureCache::loadTexture(const std::string& sourcePath, sf::Texture& texture)
+{
+	SourceInfo source = describeSource(sourcePath);
+	const FileEntry* entry = findCurrent(source);
+	if (entry == nullptr)
+	{
+		misses++;
+		if (source.exists) dirty = true; // New or changed source, the next save should pick it up
+		return false;
+	}
+	if (!texture.create(entry->width, entry->height))
+	{
+		return false;
+	}
+	texture.update((const sf::Uint8*)(file.getData() + entry->pixelOffset));
+	hits++;
+	return true;
+}
+
+void TextureCache::store(const std::string& sourcePath, sf::Image image)
+{
+	SourceInfo source = describeSource(sourcePath);
+	if (!source.exists || findCurrent(source) != nullptr) return;
+
+	std::string key = source.key;
+	stored[key] = { source, std::move(image) };
+	dirty = true;
+}
+
+// Pixels are gathered here, on the main thread, and written by a background thread. Entries still current are copied
+// across from the old mapping, which stays open for the thread until update() swaps in the new file.
+bool TextureCache::save()
+{
+	if (!dirty || cachePath.empty() || isSaving()) return false;
+
+	struct Pending
+	{
+		std::string key;
+		uint64_t fileSize;
+		int64_t modifiedTime;
+		uint32_t width, height;
+		const sf::Uint8* pixels;
+	};
+	std::vector<Pending> pending;
+	auto job = std::make_unique<SaveJob>();
+
+	for (auto& indexEntry : entryIndices)
+	{
+		if (stored.count(indexEntry.first)) continue;
+		SourceInfo source = describeSource(indexEntry.first);
+		const FileEntry* entry = findCurrent(source);
+		if (entry == nullptr) continue; // Source changed or removed
+		pending.push_back({ indexEntry.first, entry->fileSize, entry->modifiedTime, entry->width, entry->height,
+			(const sf::Uint8*)(file.getData() + entry->pixelOffset) });
+	}
+	// The images move to the job, so the pixel pointers taken from them stay valid
+	job->images.reserve(stored.size());
+	for (auto& storedEntry : stored)
+	{
+		const SourceInfo& source = storedEntry.second.first;
+		job->images.push_back(std::move(storedEntry.second.second));
+		const sf::Image& image = job->images.back();
+		pending.push_back({ storedEntry.first, source.fileSize, source.modifiedTime, image.getSize().x, image.getSize().y, image.getPixelsPtr() });
+	}
+	stored.clear();
+	dirty = false;
+
+	// Layout: header, entries, path strings, then pixel blocks aligned to 16 bytes
+	FileHeader& header = job->header;
+	header.magic = TextureCacheMagic;
+	header.version = TextureCacheVersion;
+	header.entryCount = (uint32_t)pending.size();
+	header.stringDataOffset = (uint32_t)(sizeof(FileHeader) + pending.size() * sizeof(FileEntry));
+
+	for (const Pending& p : pending)
+	{
+		FileEntry entry;
+		entry.pathOffset = (uint32_t)job->strings.size();
+		entry.pathLength = (uint32_t)p.key.size();
+		entry.fileSize = p.fileSize;
+		entry.modifiedTime = p.modifiedTime;
+		entry.width = p.width;
+		entry.height = p.height;
+		entry.pixelOffset = 0;
+		job->strings += p.key;
+		job->entries.push_back(entry);
+		job->pixels.push_back(p.pixels);
+	}
+	uint64_t offset = header.stringDataOffset + job->strings.size();
+	for (FileEntry& entry : job->entries)
+	{
+		offset = (offset + 15) & ~(uint64_t)15;
+		entry.pixelOffset = offset;
+		offset += (uint64_t)entry.width * entry.height * 4;
+	}
+
+	std::error_code error;
+	fs::create_directories(fs::path(cachePath).parent_path(), error);
+	job->tempPath = cachePath + ".tmp";
+
+	saveJob = std::move(job);
+	saveDone = false;
+	saveThread = std::thread([this]()
+		{
+			saveSucceeded = writeFile(*saveJob);
+			saveDone = true;
+		});
+	return true;
+}
+
+bool TextureCache::writeFile(const SaveJob& job)
+{
+	std::ofstream out(job.tempPath, std::ios::binary | std::ios::trunc);
+	if (!out.is_open())
+	{
+		std::cerr << "Failed to write texture cache " << job.tempPath << std::endl;
+		return false;
+	}
+	out.write((const char*)&job.header, sizeof(job.header));
+	out.write((const char*)job.entries.data(), job.entries.size() * sizeof(FileEntry));
+	out.write(job.strings.data(), job.strings.size());
+	uint64_t written = job.header.stringDataOffset + job.strings.size();
+	const char padding[16] = {};
+	for (size_t i = 0; i < job.entries.size(); i++)
+	{
+		out.write(padding, job.entries[i].pixelOffset - written);
+		uint64_t bytes = (uint64_t)job.entries[i].width * job.entries[i].height * 4;
+		out.write((const char*)job.pixels[i], bytes);
+		written = job.entries[i].pixelOffset + bytes;
+	}
+	if (!out.good())
+	{
+		std::cerr << "Failed to write texture cache " << job.tempPath << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void TextureCache::update()
+{
+	if (!saveThread.joinable() || !saveDone) return;
+	saveThread.join();
+	uint32_t entryTotal = saveJob->header.entryCount;
+	saveJob.reset(); // Frees the images that were written
+
+	if (!saveSucceeded)
+	{
+		return;
+	}
+
+	// The mapping has to go before the file can be replaced on Windows
+	file.close();
+	entries = nullptr;
+	entryCount = 0;
+	entryIndices.clear();
+
+	std::error_code error;
+	fs::rename(cachePath + ".tmp", cachePath, error);
+	if (error)
+	{
+		std::cerr << "Failed to replace texture cache " << cachePath << ": " << error.message() << std::endl;
+	}
+	else
+	{
+		std::cout << "Texture cache saved with " << entryTotal << " images" << std::endl;
+	}
+	open(cachePath);
+}
+
+void TextureCache::wait()
+{
+	if (saveThread.joinable())
+	{
+		while (!saveDone) std::this_thread::yield();
+		update();
+	}
+}
@@ -0,0 +1,104 @@
+// Texture Cache Class
+// Keeps decoded RGBA pixels for image files in a single cache file, so later runs can skip the PNG/JPG decoder.
+// Entries are keyed by the source file's path, size and modification time, and go stale as soon as any of them change.
+// The cache file is memory mapped when opened; pixels are uploaded into textures straight from the mapping.
+// New and changed images are collected with store() and written out by save(), which rebuilds the file on a background thread.
+
+#pragma once
+#include "SFML\Graphics.hpp"
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <cstdint>
+
+class TextureCache
+{
+public:
+	TextureCache();
+	~TextureCache();
+
+	// Map an existing cache file. A missing or out of date file just means every lookup misses.
+	bool open(const std::string& cachePath);
+	bool isOpen() const { return !cachePath.empty(); }
+
+	// True if the cache holds current pixels for the image file
+	bool contains(const std::string& sourcePath);
+	// Create the texture from cached pixels. Returns false on a miss.
+	bool loadTexture(const std::string& sourcePath, sf::Texture& texture);
+	// Remember decoded pixels for the image file, to be written by the next save()
+	void store(const std::string& sourcePath, sf::Image image);
+
+	// Start rewriting the cache file on a background thread, with every entry that is still current plus the stored ones.
+	// The stored images are handed to the thread and freed once written. Returns false if nothing changed or a save is running.
+	bool save();
+	bool isSaving() const { return saveThread.joinable(); }
+	// Swap in the new file once a background save is done. Call once per frame.
+	void update();
+	// Block until a background save has finished
+	void wait();
+
+	int getHitCount() const { return hits; }
+	int getMissCount() const { return misses; }
+
+private:
+	struct FileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t stringDataOffset;
+	};
+
+	struct FileEntry
+	{
+		uint32_t pathOffset;
+		uint32_t pathLength;
+		uint64_t fileSize;
+		int64_t modifiedTime;
+		uint32_t width;
+		uint32_t height;
+		uint64_t pixelOffset;
+	};
+
+	struct SourceInfo
+	{
+		std::string key;
+		uint64_t fileSize = 0;
+		int64_t modifiedTime = 0;
+		bool exists = false;
+	};
+
+	// Everything the save thread needs. Pixels point into the old mapping, which stays open until the save finishes, or into images.
+	struct SaveJob
+	{
+		FileHeader header;
+		std::vector<FileEntry> entries;
+		std::string strings;
+		std::vector<const sf::Uint8*> pixels;
+		std::vector<sf::Image> images;
+		std::string tempPath;
+	};
+
+	static SourceInfo describeSource(const std::string& sourcePath);
+	static bool writeFile(const SaveJob& job);
+	const FileEntry* findCurrent(const SourceInfo& source) const;
+
+	std::string cachePath;
+	MappedFile file;
+	const FileEntry* entries;
+	uint32_t entryCount;
+	std::unordered_map<std::string, uint32_t> entryIndices; // Canonical path to entry in the mapped file
+
+	std::unordered_map<std::string, std::pair<SourceInfo, sf::Image>> stored;
+	bool dirty;
+	std::unique_ptr<SaveJob> saveJob;
+	std::thread saveThread;
+	std::atomic<bool> saveDone;
+	bool saveSucceeded;
+	int hits;
+	int misses;
+};
@@ -1,38 +1,136 @@
+#pragma once
 #include <SFML/Graphics.hpp>
 #include <filesystem>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <iostream>
+#include <algorithm>
+#include "AsyncTextureLoader.h"
+#include "AssetCache.h"
 
 namespace fs = std::filesystem;
 
 class TextureManager {
-    std::unordered_map<std::string, sf::Texture> textures;
+    std::unordered_map<std::string, std::shared_ptr<sf::Texture>> textures; // Handles into the AssetCache, by file name
     std::vector<std::string> names;
 
+    // Files are decoded in the background and uploaded by update(). Until then getTexture hands out the placeholder.
+    AsyncTextureLoader loader;
+    sf::Texture placeholder;
+    sf::Clock loadClock;
+    bool reportLoadTime = false;
+
+    // Files with current pixels in the texture cache skip the decoder and are uploaded first
+    std::vector<std::pair<std::string, std::string>> cachedRequests; // Name, path
+    int cachedCount = 0;
+
 public:
+    // The placeholder is uploaded by the first update(), so nothing here needs a GL context
+    TextureManager() {}
+
+    // Queues every supported image in the directory. Names are available straight away, textures once update() uploads them.
     void loadTexturesFromDirectory(const std::string& path) {
+        // Packed files plus any loose files added since the pack was built. Files in both are listed once;
+        // the pack hands over to the loose copy by itself if that is newer.
+        std::vector<fs::path> files;
+        std::unordered_set<std::string> listed;
+        for (const std::string& packed : AssetCache::get().getPack().list(path)) {
+            files.push_back(packed);
+            listed.insert(files.back().filename().string());
+        }
         fs::path dir_path(path);
-        
-        if (!fs::exists(dir_path) || !fs::is_directory(dir_path)) {
+        std::error_code error;
+        if (fs::is_directory(dir_path, error)) {
+            for (const auto& entry : fs::directory_iterator(dir_path)) {
+                if (fs::is_regular_file(entry) && listed.insert(entry.path().filename().string()).second) {
+                    files.push_back(entry.path());
+                }
+            }
+        }
+        else if (files.empty()) {
             std::cerr << "Provided path is not a directory or does not exist." << std::endl;
             return;
         }
 
-        for (const auto& entry : fs::directory_iterator(dir_path)) {
-            if (fs::is_regular_file(entry) && hasSupportedExtension(entry.path().extension().string())) {
-                sf::Texture texture;
-                if (texture.loadFromFile(entry.path().string())) {
-                    std::string filename = entry.path().filename().string();
-                    textures[filename] = std::move(texture);
-                    names.push_back(filename);
-                    std::cout << "Loaded texture: " << filename << std::endl;
+        if (!isLoading()) {
+            loadClock.restart();
+            cachedCount = 0;
+        }
+        for (const fs::path& file : files) {
+            if (hasSupportedExtension(file.extension().string())) {
+                std::string filename = file.filename().string();
+                std::shared_ptr<sf::Texture> cached = AssetCache::get().findTexture(file.string());
+                if (cached) {
+                    textures[filename] = cached; // Already loaded elsewhere, no need to decode it again
+                }
+                else if (AssetCache::get().getTextureCache().contains(file.string())) {
+                    cachedRequests.push_back({ filename, file.string() });
                 }
                 else {
-					std::cerr << "Failed to load texture: " << entry.path().filename().string() << std::endl;
-				}
+                    loader.request(filename, file.string());
+                }
+                names.push_back(filename);
             }
         }
+        reportLoadTime = true;
+    }
+
+    // Uploads decoded images until the time budget is used up. Names of textures that became ready are added to loaded.
+    void update(sf::Time budget, std::vector<std::string>& loaded) {
+        sf::Clock clock;
+        if (placeholder.getSize().x == 0) {
+            sf::Image image;
+            image.create(1, 1, sf::Color(128, 128, 128));
+            placeholder.loadFromImage(image);
+        }
+        TextureCache& cache = AssetCache::get().getTextureCache();
+        while (clock.getElapsedTime() < budget && !cachedRequests.empty()) {
+            auto request = cachedRequests.back();
+            cachedRequests.pop_back();
+            sf::Texture texture;
+            if (cache.loadTexture(request.second, texture)) {
+                textures[request.first] = AssetCache::get().addTexture(request.second, std::move(texture));
+                loaded.push_back(request.first);
+                cachedCount++;
+            }
+            else {
+                loader.request(request.first, request.second); // Source changed since it was queued
+            }
+        }
+
+        AsyncTextureLoader::DecodedImage decoded;
+        while (clock.getElapsedTime() < budget && loader.poll(decoded)) {
+            sf::Texture texture;
+            if (decoded.loaded && texture.loadFromImage(decoded.image)) {
+                textures[decoded.name] = AssetCache::get().addTexture(decoded.path, std::move(texture));
+                loaded.push_back(decoded.name);
+                cache.store(decoded.path, std::move(decoded.image));
+            }
+            else {
+                std::cerr << "Failed to load texture: " << decoded.name << std::endl;
+                names.erase(std::remove(names.begin(), names.end(), decoded.name), names.end());
+            }
+        }
+
+        if (reportLoadTime && !isLoading()) {
+            std::cout << "Loaded " << textures.size() << " textures in " << loadClock.getElapsedTime().asMilliseconds() << " ms ("
+                << cachedCount << " from cache)" << std::endl;
+#ifdef _DEBUG
+            AssetCache::get().printReport();
+#endif
+            reportLoadTime = false;
+        }
+
+        // Decoded images are written out in the background once loading settles, again after any later loads
+        cache.update();
+        if (!isLoading()) {
+            cache.save();
+        }
+    }
+
+    bool isLoading() {
+        return loader.getPendingCount() > 0 || !cachedRequests.empty();
     }
 
     bool hasSupportedExtension(const std::string& ext) const {
@@ -43,11 +141,23 @@ public:
         return names;
     }
 
+    bool isReady(const std::string& name) const {
+        return textures.find(name) != textures.end();
+    }
+
+    // Returns the placeholder for textures still loading, and nullptr for names that were never requested
     sf::Texture* getTexture(const std::string& name) {
         auto it = textures.find(name);
         if (it != textures.end()) {
-            return &it->second;
+            return it->second.get();
+        }
+        if (std::find(names.begin(), names.end(), name) != names.end()) {
+            return &placeholder;
         }
         return nullptr;
     }
-};
\ No newline at end of file
+
+    sf::Texture* getPlaceholder() {
+        return &placeholder;
+    }
+};
@@ -3,10 +3,14 @@
 #include "imgui.h"
 #include "imgui-SFML.h"
 #include "Utilities.h"
+#include "LevelFile.h"
 
 TileManager::TileManager()
 {
     filePath = "TilesData.txt";
+    showDebugCollisionBox = false;
+    renderer = nullptr;
+    tileOutlines.setEnabled(true);
     textureManager.loadTexturesFromDirectory("gfx/TileTextures");
     // Set up ImGui variables
     imguiWidth = SCREEN_WIDTH / 4;
@@ -16,9 +20,18 @@ TileManager::TileManager()
 void TileManager::handleInput(float dt)
 {
     sf::Vector2i pixelPos = sf::Vector2i(input->getMouseX(), input->getMouseY());
+    // Select where the click landed, the mouse may have moved on by the time the frame is processed
+    input->getMousePressPosition(InputEvent::Left, pixelPos.x, pixelPos.y);
     sf::Vector2f worldPos = window->mapPixelToCoords(pixelPos, *view);
 
-    if (input->isLeftMouseDown()) {
+    // Collectables picked up while playing are part of the level again in the editor
+    if (!collectedTiles.empty()) {
+        restoreCollectables();
+    }
+    // Catch edits made since the last frame, including through the ImGui panel
+    journalSelectedTiles();
+
+    if (input->isLeftMousePressed()) {
         bool tileClicked = false;
         int clickedTileIndex = -1;
 
@@ -34,34 +47,25 @@ void TileManager::handleInput(float dt)
         if (tileClicked) {
             if (input->isKeyDown(sf::Keyboard::LControl) || input->isKeyDown(sf::Keyboard::RControl)) {
                 // Ctrl is held, toggle the selection state of the tile
-                if (selectedTileIndices.find(clickedTileIndex) == selectedTileIndices.end()) {
-                    selectedTileIndices.insert(clickedTileIndex); // Add to selection
-                    tiles[clickedTileIndex]->setEditing(true);
+                if (!tiles[clickedTileIndex]->isSelected()) {
+                    selectTile(*tiles[clickedTileIndex]); // Add to selection
                 }
                 else {
-                    selectedTileIndices.erase(clickedTileIndex); // Remove from selection
-                    tiles[clickedTileIndex]->setEditing(false);
+                    deselectTile(*tiles[clickedTileIndex]); // Remove from selection
                 }
             }
             else {
                 // No Ctrl key, clear existing selections and select the new tile only
-                for (auto index : selectedTileIndices) {
-                    tiles[index]->setEditing(false); // Set all currently selected tiles to not editing
-                }
-                selectedTileIndices.clear();
-                selectedTileIndices.insert(clickedTileIndex);
-                tiles[clickedTileIndex]->setEditing(true);
+                clearSelection();
+                selectTile(*tiles[clickedTileIndex]);
             }
         }
         else {
             // Clicked on empty space
             if (!(input->isKeyDown(sf::Keyboard::LControl) || input->isKeyDown(sf::Keyboard::RControl))) {
-                if (!selectedTileIndices.empty()) {
+                if (!selectedTiles.empty()) {
                     // Clear all current selections
-                    for (auto index : selectedTileIndices) {
-                        tiles[index]->setEditing(false); // Set all currently selected tiles to not editing
-                    }
-                    selectedTileIndices.clear();
+                    clearSelection();
                     // Set a flag or remember this state to know a clearing has just occurred
                     //recentlyCleared = true;
                 }
@@ -69,54 +73,38 @@ void TileManager::handleInput(float dt)
                     // Create a new tile only if it was recently cleared and now clicking again on empty space
                     auto newTile = std::make_unique<Tiles>();
                     newTile->setPosition(worldPos.x, worldPos.y);
-                    world->AddGameObject(*newTile);
-                    tiles.push_back(std::move(newTile));
-                    int newIndex = tiles.size() - 1; // Get the index of the newly added tile
-                    selectedTileIndices.insert(newIndex); // Select the newly added tile
-                    tiles[newIndex]->setEditing(true);
+                    Tiles& tile = addTile(std::move(newTile));
+                    journalAdd(tile);
+                    selectTile(tile); // Select the newly added tile
                     recentlyCleared = false; // Reset the flag
                 }
             }
             else {
                 // If Ctrl is held, only clear selection without adding a new tile
-                for (auto index : selectedTileIndices) {
-                    tiles[index]->setEditing(false); // Set all currently selected tiles to not editing
-                }
-                selectedTileIndices.clear();
+                clearSelection();
                 //recentlyCleared = false; // Ensure the flag is reset even if Ctrl was held
             }
         }
-        input->setLeftMouse(Input::MouseState::UP); // Mark the mouse click as handled
     }
 
     // Handle input for the active tiles
-    for (int index : selectedTileIndices) {
-        tiles[index]->setInput(input);
-        tiles[index]->handleInput(dt);
-    }
-
-    // Update the color of the tiles based on selection and tag
-    for (int i = 0; i < tiles.size(); ++i) {
-        if (selectedTileIndices.find(i) != selectedTileIndices.end()) {
-            tiles[i]->setColor(sf::Color::Green); // Highlight selected tiles
-        }
-        else if (tiles[i]->getTag() == "Wall") {
-            tiles[i]->setColor(sf::Color::Blue);
-        }
-        else {
-            tiles[i]->setColor(sf::Color::Red);
-        }
+    for (Handle h : selectedTiles) {
+        Tiles& tile = getTile(h);
+        sf::Vector2f before = tile.getPosition();
+        tile.setInput(input);
+        tile.handleInput(dt);
+        if (tile.getPosition() != before) selectionEdited = true;
     }
 
     // Additional functionality like duplication and deletion...
 
     // Duplication
     if (input->isKeyDown(sf::Keyboard::LControl) || input->isKeyDown(sf::Keyboard::RControl)) {
-        if (input->isKeyDown(sf::Keyboard::D)) {
+        if (input->isPressed(sf::Keyboard::D)) {
             // Duplicate all selected tiles
             std::vector<std::unique_ptr<Tiles>> newTiles; // Temporarily store new tiles to avoid modifying the collection while iterating
-            for (int index : selectedTileIndices) {
-                auto& tile = tiles[index];
+            for (Handle h : selectedTiles) {
+                Tiles* tile = &getTile(h);
                 auto duplicatedTile = std::make_unique<Tiles>();
                 duplicatedTile->setPosition(tile->getPosition());
                 duplicatedTile->setSize(tile->getSize());
@@ -130,31 +118,20 @@ void TileManager::handleInput(float dt)
 
             // Add new tiles to the main collection and select them
             for (auto& newTile : newTiles) {
-                world->AddGameObject(*newTile);
-                int newIndex = tiles.size();
-                tiles.push_back(std::move(newTile));
-                selectedTileIndices.insert(newIndex); // Select new tiles
+                Tiles& tile = addTile(std::move(newTile));
+                journalAdd(tile);
+                selectTile(tile); // Select new tiles
             }
-
-            input->setKeyUp(sf::Keyboard::D); // Prevent continuous duplication while the key is held down
         }
     }
 
     //Deletion
-    if (input->isKeyDown(sf::Keyboard::Delete)) {
-        // Sort selected indices in descending order to safely delete multiple tiles without invalidating indices
-        std::vector<int> sortedIndices(selectedTileIndices.begin(), selectedTileIndices.end());
-        std::sort(sortedIndices.rbegin(), sortedIndices.rend()); // Reverse sort
-
-        for (int index : sortedIndices) {
-            if (index >= 0 && index < tiles.size()) {
-                world->RemoveGameObject(*tiles[index]);
-                tiles.erase(tiles.begin() + index);
-            }
-        }
-        selectedTileIndices.clear(); // Clear selection after deletion
-        input->setKeyUp(sf::Keyboard::Delete); // Prevent continuous deletion while the key is held down
+    if (input->isPressed(sf::Keyboard::Delete)) {
+        deleteSelectedTiles();
     }
+
+    // Edits made this frame, and start tracking newly selected tiles before the ImGui panel can change them
+    journalSelectedTiles();
 }
 void TileManager::update(float dt)
 {
@@ -163,28 +140,150 @@ void TileManager::update(float dt)
             tilePtr->update(dt); // Dereference the pointer to get the Tiles object
         }
     }
+    if (streaming) {
+        streamer.forEachTile([dt](Tiles& tile) { tile.update(dt); });
+    }
+}
+
+bool TileManager::enableStreaming(const std::string& chunkDirectory)
+{
+    streamer.setWorld(world);
+    streamer.setTextureManager(&textureManager);
+    if (!streamer.open(chunkDirectory)) {
+        return false;
+    }
+    // The chunks stand in for the resident tiles in play. Any already loaded leave the World until the editor is done with them.
+    if (!streaming && tilesLoaded) {
+        std::vector<GameObject*> resident;
+        resident.reserve(tiles.size());
+        for (auto& tilePtr : tiles) {
+            resident.push_back(tilePtr.get());
+        }
+        world->RemoveGameObjects(resident);
+    }
+    streaming = true;
+    std::cout << "Streaming level chunks from " << chunkDirectory << std::endl;
+    return true;
+}
+
+void TileManager::disableStreaming()
+{
+    streamer.close();
+    if (!streaming) return;
+    streaming = false;
+    dirtyChunks.clear();
+    allChunksDirty = false;
+
+    // The resident tiles are the play tiles again
+    if (tilesLoaded) {
+        for (auto& tilePtr : tiles) {
+            world->AddGameObject(*tilePtr);
+        }
+    }
+    else {
+        loadTiles();
+    }
+}
+
+void TileManager::beginEditing()
+{
+    if (!tilesLoaded && !loadTiles()) {
+        std::cout << "Tiles not found\n";
+    }
+}
+
+void TileManager::endEditing()
+{
+    saveLevel();
+    if (streaming) {
+        // Play reads the chunks saveLevel just wrote, so the resident tiles are not needed until the editor is entered again
+        unloadTiles();
+        std::string chunkDirectory = streamer.getDirectory();
+        streamer.open(chunkDirectory);
+    }
+}
+
+// Textures that finished last time are put on their waiting tiles first, then uploads get what is left of the
+// budget. A texture used by more tiles than fit in one frame carries on in the next.
+void TileManager::updateTextures()
+{
+    const sf::Time budget = sf::milliseconds(4);
+    sf::Clock clock;
+
+    while (!readyTextures.empty() && clock.getElapsedTime() < budget) {
+        const std::string& name = readyTextures.back();
+        sf::Texture* texture = textureManager.getTexture(name);
+        auto it = tilesAwaitingTexture.find(name);
+        if (it != tilesAwaitingTexture.end()) {
+            std::vector<Handle>& waiting = it->second;
+            int applied = 0;
+            while (!waiting.empty()) {
+                // Checking the clock every tile would cost more than setting the texture
+                if (++applied % 64 == 0 && clock.getElapsedTime() >= budget) break;
+                Handle h = waiting.back();
+                waiting.pop_back();
+                if (!tileHandles.isAlive(h)) continue;
+                Tiles& tile = getTile(h);
+                if (tile.getTextureName() != name) continue; // Changed in the editor since
+                tile.setTexture(texture, true);
+                staticLayer.markDirty(tile.getGlobalBounds());
+            }
+            if (!waiting.empty()) break;
+            tilesAwaitingTexture.erase(it);
+        }
+        if (streaming) {
+            streamer.applyTexture(name, texture);
+        }
+        readyTextures.pop_back();
+    }
+
+    sf::Time elapsed = clock.getElapsedTime();
+    if (elapsed < budget) {
+        textureManager.update(budget - elapsed, readyTextures);
+    }
 }
 
 void TileManager::render(bool editMode) {
+    // Outside the editor static tiles come from the cache, drawn underneath everything else
+    bool useStaticLayer = false;
+    bool drawResident = editMode || !streaming;
+    if (!editMode && !streaming && renderer->supportsRenderTextures()) {
+        staticLayer.update(tiles);
+        useStaticLayer = staticLayer.isAvailable();
+        if (useStaticLayer) staticLayer.render(*renderer);
+    }
+
     for (auto& tilePtr : tiles) {
+        if (!drawResident) break;
         if (tilePtr) { // Check if the pointer is not null
             if (editMode) {
-                sf::RectangleShape rect = tilePtr->getDebugCollisionBox();
-                rect.setOutlineThickness(5);
-                int tileIndex = &tilePtr - &tiles[0]; // Get index of the tile
-
                 // Highlight selected tiles
-                if (selectedTileIndices.find(tileIndex) != selectedTileIndices.end()) {
-                    rect.setOutlineColor(sf::Color::Green);
+                if (tilePtr->isSelected()) {
+                    tileOutlines.addBox(tilePtr->getCollisionBox(), sf::Color::Green, 5.f);
                 } else {
-                    rect.setOutlineColor(sf::Color::Red);
+                    tileOutlines.addBox(tilePtr->getCollisionBox(), sf::Color::Red, 5.f);
                 }
-                
-                window->draw(rect);
             }
-            if(!tilePtr->getTexture()==NULL) window->draw(*tilePtr); // Draw the tile
+            if (useStaticLayer && StaticLayerCache::isCached(*tilePtr)) continue; // Already in the static layer
+            if (tilePtr->getTexture() != nullptr) spriteBatch.submit(*tilePtr); // Queue the tile for drawing
         }
     }
+    // Streamed chunks are only resident near the view, so they are drawn directly rather than cached
+    if (streaming && !editMode) {
+        streamer.forEachTile([this](Tiles& tile) {
+            if (tile.getTexture() != nullptr) spriteBatch.submit(tile);
+        });
+    }
+    spriteBatch.flush(*renderer);
+
+    // Tile outlines, then debug boxes and contact points, go on top of the tiles. One draw call each.
+    if (editMode) {
+        tileOutlines.render(*renderer);
+        debugDraw.render(*renderer);
+    }
+    else {
+        debugDraw.clear();
+    }
 }
 
 
@@ -208,68 +307,325 @@ void TileManager::render(bool editMode) {
 //}
 void TileManager::saveTiles(const std::vector<std::unique_ptr<Tiles>>& tiles, const std::string& filePath)
 {
-    std::ofstream file(filePath);
-    if (!file.is_open()) {
-        std::cout << "Failed to open file for saving tiles." << std::endl;
-        return;
+    std::vector<LevelTile> levelTiles;
+    levelTiles.reserve(tiles.size());
+    for (const auto& tile : tiles) {
+        levelTiles.push_back(describeTile(*tile));
     }
 
-    for (const auto& tile : tiles) {
-        file << tile->getTag() << ","
-            << tile->getPosition().x << ","
-            << tile->getPosition().y << ","
-            << tile->getSize().x << ","
-            << tile->getSize().y << ","
-            << tile->getTrigger() << ","
-            << tile->getStatic() << ","
-            << tile->getMassless() << ","
-            << tile->getTile() << ","
-            << tile->getTextureName() << "\n";  // Ensure the texture name is always written, even if it's empty
+    // .lvl files are saved in the binary format, anything else as CSV
+    if (LevelFile::isBinary(filePath)) {
+        LevelFile::writeBinary(filePath, levelTiles);
+    }
+    else {
+        LevelFile::writeCsv(filePath, levelTiles);
     }
 }
 
 bool TileManager::loadTiles()
 {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cout << "Failed to open file for loading tiles." << std::endl;
+    // Unsaved edits from last session (or a crash) are replayed from the journal on top of the level file
+    journal.open(filePath);
+    tilesLoaded = true; // Even if there is no level file yet, so tiles placed in the editor are not joined by a second load
+    bool loaded;
+    if (journal.hasEdits()) {
+        allChunksDirty = streaming; // Chunks built before these edits do not have them
+        loaded = loadJournalledTiles();
+    }
+    else {
+        loaded = LevelFile::isBinary(filePath) ? loadBinaryTiles() : loadCsvTiles();
+        for (unsigned int i = 0; i < tiles.size(); ++i) {
+            tiles[i]->setJournalId(i); // Journal ids are positions in the level file
+        }
+        nextTileId = (unsigned int)tiles.size();
+    }
+    if (!loaded) {
         return false;
     }
 
-    std::string line;
-    while (std::getline(file, line)) {
-        std::stringstream linestream(line);
-        std::string segment;
-        std::vector<std::string> seglist;
-
-        while (std::getline(linestream, segment, ',')) {
-            seglist.push_back(segment);
-        }
-
-        if (seglist.size() >= 9) {
-            auto newTile = std::make_unique<Tiles>();
-            newTile->setTag(seglist[0]);
-            newTile->setPosition(sf::Vector2f(std::stof(seglist[1]), std::stof(seglist[2])));
-            newTile->setSize(sf::Vector2f(std::stof(seglist[3]), std::stof(seglist[4])));
-            newTile->setTrigger(std::stoi(seglist[5]));
-            newTile->setStatic(std::stoi(seglist[6]));
-            newTile->setMassless(std::stoi(seglist[7]));
-            newTile->setTile(std::stoi(seglist[8]));
-
-            // Check if a texture name exists and is valid
-            if (seglist.size() > 9 && !seglist[9].empty()) {
-                newTile->setTextureName(seglist[9]);
-                sf::Texture* texture = textureManager.getTexture(seglist[9]);
-                if (texture) {
-                    newTile->setTexture(texture);
-                }
+    // Colours only change with selection from here on
+    for (auto& tile : tiles) {
+        updateTileColour(*tile);
+    }
+    staticLayer.markAllDirty();
+    return true;
+}
+
+void TileManager::unloadTiles()
+{
+    if (!streaming) {
+        std::vector<GameObject*> resident;
+        resident.reserve(tiles.size());
+        for (auto& tilePtr : tiles) {
+            resident.push_back(tilePtr.get());
+        }
+        world->RemoveGameObjects(resident);
+    }
+    selectedTiles.clear();
+    journalSnapshots.clear();
+    selectionEdited = false;
+    activeTileIndex = -1;
+    tilesAwaitingTexture.clear();
+    tileHandles.clear();
+    tiles.clear();
+    tiles.shrink_to_fit();
+    collectedTiles.clear();
+    staticLayer.markAllDirty();
+    tilesLoaded = false;
+}
+
+bool TileManager::loadJournalledTiles()
+{
+    std::vector<LevelTile> levelTiles;
+    std::vector<unsigned int> ids;
+    if (!journal.replay(levelTiles, ids)) {
+        return false;
+    }
+
+    nextTileId = 0;
+    for (size_t i = 0; i < levelTiles.size(); ++i) {
+        const LevelTile& levelTile = levelTiles[i];
+        auto newTile = std::make_unique<Tiles>();
+        newTile->setTag(levelTile.tag);
+        newTile->setPosition(levelTile.position);
+        newTile->setSize(levelTile.size);
+        newTile->setTrigger(levelTile.trigger);
+        newTile->setStatic(levelTile.isStatic);
+        newTile->setMassless(levelTile.massless);
+        newTile->setTile(levelTile.tile);
+        if (!levelTile.textureName.empty()) {
+            newTile->setTextureName(levelTile.textureName);
+            sf::Texture* texture = textureManager.getTexture(levelTile.textureName);
+            if (texture) {
+                newTile->setTexture(texture);
             }
+        }
+        newTile->setJournalId(ids[i]);
+        nextTileId = std::max(nextTileId, ids[i] + 1);
+
+        addTile(std::move(newTile));
+    }
 
-            world->AddGameObject(*newTile);
-            tiles.push_back(std::move(newTile));
+    // A save was cut short last time; finish it now so the journals start clean
+    if (journal.needsRecovery() && journal.compactNow(levelTiles)) {
+        for (unsigned int i = 0; i < tiles.size(); ++i) {
+            tiles[i]->setJournalId(i);
         }
+        nextTileId = (unsigned int)tiles.size();
     }
+    return true;
+}
 
+void TileManager::saveLevel()
+{
+    journalSelectedTiles();
+
+    // Removal reorders the tiles vector, so write the tiles in journal id order. That is the order recovery
+    // renumbers survivors in if this save is interrupted, so records chained onto it still find the right tiles.
+    std::vector<Tiles*> ordered;
+    ordered.reserve(tiles.size());
+    for (auto& tile : tiles) {
+        ordered.push_back(tile.get());
+    }
+    for (auto& tile : collectedTiles) {
+        ordered.push_back(tile.get()); // Still part of the level
+    }
+    std::sort(ordered.begin(), ordered.end(), [](Tiles* a, Tiles* b) { return a->getJournalId() < b->getJournalId(); });
+
+    std::vector<LevelTile> snapshot;
+    snapshot.reserve(ordered.size());
+    for (Tiles* tile : ordered) {
+        snapshot.push_back(describeTile(*tile));
+    }
+    if (streaming) {
+        writeDirtyChunks(snapshot);
+    }
+
+    // The new level file lists tiles in that order, so journal ids restart from each tile's position in it
+    if (journal.compact(std::move(snapshot))) {
+        for (unsigned int i = 0; i < ordered.size(); ++i) {
+            ordered[i]->setJournalId(i);
+        }
+        nextTileId = (unsigned int)ordered.size();
+        resetJournalSnapshots(); // Keyed by the new ids
+    }
+}
+
+void TileManager::updateJournal()
+{
+    journal.flush(); // Everything edited this frame, so at most a frame of edits is lost in a crash
+    journal.update();
+    if (journal.getRecordCount() > 5000 && !journal.isCompacting()) {
+        saveLevel();
+    }
+}
+
+LevelTile TileManager::describeTile(Tiles& tile)
+{
+    LevelTile levelTile;
+    levelTile.tag = tile.getTag();
+    levelTile.position = tile.getPosition();
+    levelTile.size = tile.getSize();
+    levelTile.trigger = tile.getTrigger();
+    levelTile.isStatic = tile.getStatic();
+    levelTile.massless = tile.getMassless();
+    levelTile.tile = tile.getTile();
+    levelTile.textureName = tile.getTextureName();  // Ensure the texture name is always written, even if it's empty
+    return levelTile;
+}
+
+void TileManager::journalAdd(Tiles& tile)
+{
+    tile.setJournalId(nextTileId++);
+    staticLayer.markDirty(tile.getGlobalBounds());
+    LevelTile state = describeTile(tile);
+    markChunkDirty(sf::FloatRect(state.position, state.size));
+    journal.recordAdd(tile.getJournalId(), state);
+    journalSnapshots[tile.getJournalId()] = { &tile, state };
+}
+
+void TileManager::journalDelete(Tiles& tile)
+{
+    journal.recordDelete(tile.getJournalId());
+    journalSnapshots.erase(tile.getJournalId());
+    markChunkDirty(sf::FloatRect(tile.getPosition(), tile.getSize()));
+}
+
+// Chunks go by the tile's position and size, as written to them, rather than its drawn bounds
+void TileManager::markChunkDirty(const sf::FloatRect& bounds)
+{
+    if (streaming) {
+        dirtyChunks.insert(LevelStreamer::getChunkKey(bounds, streamer.getChunkSize()));
+    }
+}
+
+void TileManager::writeDirtyChunks(const std::vector<LevelTile>& level)
+{
+    if (!allChunksDirty && dirtyChunks.empty()) return;
+    if (LevelStreamer::writeChunks(level, streamer.getDirectory(), streamer.getChunkSize(), allChunksDirty ? nullptr : &dirtyChunks)) {
+        dirtyChunks.clear();
+        allChunksDirty = false;
+    }
+}
+
+void TileManager::journalSelectedTiles()
+{
+    if (!selectionEdited) return;
+    selectionEdited = false;
+
+    // Every edit ends up here, so this is where the static layer and the chunks are told about it: the area the tile left and the one it is in now
+    for (auto& entry : journalSnapshots) {
+        LevelTile state = describeTile(*entry.second.tile);
+        if (!EditJournal::sameTile(state, entry.second.state)) {
+            staticLayer.markDirty(sf::FloatRect(entry.second.state.position, entry.second.state.size));
+            staticLayer.markDirty(entry.second.tile->getGlobalBounds());
+            markChunkDirty(sf::FloatRect(entry.second.state.position, entry.second.state.size));
+            markChunkDirty(sf::FloatRect(state.position, state.size));
+            journal.recordModify(entry.first, state);
+            entry.second.state = std::move(state);
+        }
+    }
+}
+
+void TileManager::resetJournalSnapshots()
+{
+    journalSnapshots.clear();
+    for (Handle h : selectedTiles) {
+        Tiles& tile = getTile(h);
+        journalSnapshots[tile.getJournalId()] = { &tile, describeTile(tile) };
+    }
+}
+
+// Rows are read in place from the mapped file. Tags and textures are looked up once per distinct name, not per tile.
+bool TileManager::loadCsvTiles()
+{
+    CsvTileReader reader;
+    if (!reader.open(filePath)) {
+        return false;
+    }
+
+    std::unordered_map<std::string_view, TagId> tagIds;
+    std::unordered_map<std::string_view, sf::Texture*> textures;
+
+    CsvTile row;
+    while (reader.next(row)) {
+        auto tagIt = tagIds.find(row.tag);
+        if (tagIt == tagIds.end()) {
+            tagIt = tagIds.emplace(row.tag, Tags::getId(std::string(row.tag))).first;
+        }
+
+        auto newTile = std::make_unique<Tiles>();
+        newTile->setTagId(tagIt->second);
+        newTile->setPosition(row.position);
+        newTile->setSize(row.size);
+        newTile->setTrigger(row.trigger);
+        newTile->setStatic(row.isStatic);
+        newTile->setMassless(row.massless);
+        newTile->setTile(row.tile);
+
+        // Check if a texture name exists and is valid
+        if (!row.textureName.empty()) {
+            auto textureIt = textures.find(row.textureName);
+            if (textureIt == textures.end()) {
+                textureIt = textures.emplace(row.textureName, textureManager.getTexture(std::string(row.textureName))).first;
+            }
+            newTile->setTextureName(std::string(row.textureName));
+            if (textureIt->second) {
+                newTile->setTexture(textureIt->second);
+            }
+        }
+
+        addTile(std::move(newTile));
+    }
+    return true;
+}
+
+// Reads tile records straight out of the mapped file. Tags and textures are looked up once per string table entry, not per tile.
+bool TileManager::loadBinaryTiles()
+{
+    LevelFileView level;
+    if (!level.open(filePath)) {
+        std::cout << "Failed to open file for loading tiles." << std::endl;
+        return false;
+    }
+
+    uint32_t stringCount = level.getStringCount();
+    std::vector<TagId> tagIds(stringCount, UnknownTag); // UnknownTag until resolved
+    std::vector<sf::Texture*> textures(stringCount, nullptr);
+    std::vector<bool> texturesResolved(stringCount, false);
+
+    tiles.reserve(tiles.size() + level.getTileCount());
+    for (uint32_t i = 0; i < level.getTileCount(); ++i) {
+        const LevelTileRecord& record = level.getTile(i);
+        if (record.tag >= stringCount || record.texture >= stringCount) {
+            continue;
+        }
+        if (tagIds[record.tag] == UnknownTag) {
+            tagIds[record.tag] = Tags::getId(level.getString(record.tag));
+        }
+        if (!texturesResolved[record.texture]) {
+            textures[record.texture] = textureManager.getTexture(level.getString(record.texture));
+            texturesResolved[record.texture] = true;
+        }
+
+        auto newTile = std::make_unique<Tiles>();
+        newTile->setTagId(tagIds[record.tag]);
+        newTile->setPosition(record.x, record.y);
+        newTile->setSize(sf::Vector2f(record.width, record.height));
+        newTile->setTrigger((record.flags & LevelTileRecord::TRIGGER) != 0);
+        newTile->setStatic((record.flags & LevelTileRecord::STATIC) != 0);
+        newTile->setMassless((record.flags & LevelTileRecord::MASSLESS) != 0);
+        newTile->setTile((record.flags & LevelTileRecord::TILE) != 0);
+
+        if (record.texture != 0) {
+            newTile->setTextureName(level.getString(record.texture));
+            if (textures[record.texture]) {
+                newTile->setTexture(textures[record.texture]);
+            }
+        }
+
+        addTile(std::move(newTile));
+    }
     return true;
 }
 
@@ -280,18 +636,15 @@ std::vector<std::unique_ptr<Tiles>>& TileManager::getTiles() {
 
 void TileManager::RemoveCollectable()
 {
-    auto newEnd = std::remove_if(tiles.begin(), tiles.end(),
-        [this](const std::unique_ptr<Tiles>& tilePtr) -> bool
-        {
-            if (tilePtr->CollisionWithTag("Player") && tilePtr->getTag()== "Collectable")
-            {
-                world->RemoveGameObject(*tilePtr);
-                return true; // Mark for removal
-            }
-            return false; // Keep in the vector
-        });
-
-    tiles.erase(newEnd, tiles.end());
+    std::vector<Handle> collected;
+    for (auto& tilePtr : tiles) {
+        if (tilePtr->CollisionWithTag("Player") && tilePtr->getTag() == "Collectable") {
+            collected.push_back(tilePtr->getTileHandle());
+        }
+    }
+    if (!collected.empty()) {
+        removeTiles(collected, &collectedTiles); // Picked up in play, not an edit to the level
+    }
 }
 
 void TileManager::DrawImGui() {
@@ -358,33 +711,34 @@ void TileManager::DrawImGui() {
                         std::string item_label = tiles[i]->getTag().empty() ? "Tile" + std::to_string(i) : tiles[i]->getTag();
                         item_label += "##" + std::to_string(i);
 
-                        bool isSelected = selectedTileIndices.find(i) != selectedTileIndices.end();
+                        bool isSelected = tiles[i]->isSelected();
                         if (ImGui::Selectable(item_label.c_str(), isSelected)) {
                             if (ImGui::GetIO().KeyCtrl) {
                                 // Toggle selection with Ctrl pressed
                                 if (isSelected) {
-                                    selectedTileIndices.erase(i);
+                                    deselectTile(*tiles[i]);
                                 }
                                 else {
-                                    selectedTileIndices.insert(i);
+                                    selectTile(*tiles[i]);
                                 }
                             }
                             else {
                                 // Single selection
-                                selectedTileIndices.clear();
-                                selectedTileIndices.insert(i);
+                                clearSelection();
+                                selectTile(*tiles[i]);
                             }
                         }
                     }
                     ImGui::EndListBox();
                 }
 
-                if (!selectedTileIndices.empty()) {
+                if (!selectedTiles.empty()) {
 
                     // Buttons for setting properties to common types
                     if (ImGui::Button("Convert to Collectable")) {
-                        for (int idx : selectedTileIndices) {
-                            auto& tile = *tiles[idx];
+                        selectionEdited = true;
+                        for (Handle h : selectedTiles) {
+                            Tiles& tile = getTile(h);
                             tile.setMassless(true);
                             tile.setTrigger(true);
                             tile.setTile(true);
@@ -398,8 +752,9 @@ void TileManager::DrawImGui() {
                     }
 
                     if (ImGui::Button("Convert to Platform")) {
-                        for (int idx : selectedTileIndices) {
-                            auto& tile = *tiles[idx];
+                        selectionEdited = true;
+                        for (Handle h : selectedTiles) {
+                            Tiles& tile = getTile(h);
                             tile.setStatic(true);
                             tile.setTile(true);
                             tile.setTrigger(false);
@@ -413,8 +768,9 @@ void TileManager::DrawImGui() {
                     }
 
                     if (ImGui::Button("Convert to Checkpoint")) {
-                        for (int idx : selectedTileIndices) {
-                            auto& tile = *tiles[idx];
+                        selectionEdited = true;
+                        for (Handle h : selectedTiles) {
+                            Tiles& tile = getTile(h);
                             tile.setStatic(true);
                             tile.setTrigger(true);
                             tile.setTile(true);
@@ -427,13 +783,13 @@ void TileManager::DrawImGui() {
                         ImGui::SetTooltip("Use these settings to convert the selected tile(s) to a Checkpoint.");
                     }
 
-                    ImGui::Text("Selected Tiles: %d", (int)selectedTileIndices.size());
+                    ImGui::Text("Selected Tiles: %d", (int)selectedTiles.size());
                     displayTilePositions();  // Edit positions
                     displayTileScales();     // Edit scales
 
                     // Display properties if tiles have the same tag or only one is selected
-                    if (selectedTileIndices.size() == 1 || allTilesHaveSameTag()) {
-                        auto& firstTile = *tiles[*selectedTileIndices.begin()];
+                    if (selectedTiles.size() == 1 || allTilesHaveSameTag()) {
+                        auto& firstTile = getTile(selectedTiles.front());
                         displayTileProperties(firstTile);
                     }
 
@@ -450,7 +806,7 @@ void TileManager::DrawImGui() {
 
 
                 if (ImGui::Button("Save")) {
-                    saveTiles(tiles, filePath);
+                    saveLevel();
                 }
 
 
@@ -474,10 +830,10 @@ void TileManager::DrawImGui() {
 
 
 void TileManager::displayTextureSelection(TextureManager& textureManager) {
-    if (selectedTileIndices.empty()) return;
+    if (selectedTiles.empty()) return;
 
     // Assume first selected tile's texture as the default for simplicity
-    std::string currentTextureName = tiles[*selectedTileIndices.begin()]->getTextureName();
+    std::string currentTextureName = getTile(selectedTiles.front()).getTextureName();
     const std::vector<std::string>& textureNames = textureManager.getTextureNames();
 
     // Find the current index based on the texture name
@@ -494,14 +850,15 @@ void TileManager::displayTextureSelection(TextureManager& textureManager) {
         for (int n = 0; n < textureNames.size(); n++) {
             bool is_selected = (current_item == n);
             if (ImGui::Selectable(textureNames[n].c_str(), is_selected)) {
+                selectionEdited = true;
                 // Set the new current item
                 current_item = n;
                 // Update the texture on all selected tiles
                 sf::Texture* selectedTexture = textureManager.getTexture(textureNames[n]);
-                for (auto idx : selectedTileIndices) 
+                for (Handle h : selectedTiles) 
                 {
-                    tiles[idx]->setTexture(selectedTexture,true);
-                    tiles[idx]->setTextureName(textureNames[n]);  // Save the texture name
+                    getTile(h).setTexture(selectedTexture,true);
+                    getTile(h).setTextureName(textureNames[n]);  // Save the texture name
                 }
                 
             }
@@ -516,22 +873,23 @@ void TileManager::displayTextureSelection(TextureManager& textureManager) {
 
 
 void TileManager::displayTilePositions() {
-    if (selectedTileIndices.empty()) return;
+    if (selectedTiles.empty()) return;
 
     // Compute an average position to start with for simplicity
     sf::Vector2f averagePos(0, 0);
-    for (int idx : selectedTileIndices) {
-        averagePos += tiles[idx]->getPosition();
+    for (Handle h : selectedTiles) {
+        averagePos += getTile(h).getPosition();
     }
-    averagePos.x /= selectedTileIndices.size();
-    averagePos.y /= selectedTileIndices.size();
+    averagePos.x /= selectedTiles.size();
+    averagePos.y /= selectedTiles.size();
 
     sf::Vector2f newPos = averagePos;
     if (ImGui::DragFloat2("Position", &newPos.x, 0.5f, 0, 0, "%.3f")) {
+        selectionEdited = true;
         sf::Vector2f deltaPos = newPos - averagePos;
-        for (int idx : selectedTileIndices) {
-            sf::Vector2f currentPos = tiles[idx]->getPosition();
-            tiles[idx]->setPosition(currentPos + deltaPos);
+        for (Handle h : selectedTiles) {
+            sf::Vector2f currentPos = getTile(h).getPosition();
+            getTile(h).setPosition(currentPos + deltaPos);
         }
     }
     if (ImGui::IsItemHovered())
@@ -541,22 +899,23 @@ void TileManager::displayTilePositions() {
 }
 
 void TileManager::displayTileScales() {
-    if (selectedTileIndices.empty()) return;
+    if (selectedTiles.empty()) return;
 
     // Compute an average scale to start with for simplicity
     sf::Vector2f averageScale(0, 0);
-    for (int idx : selectedTileIndices) {
-        averageScale += tiles[idx]->getSize();
+    for (Handle h : selectedTiles) {
+        averageScale += getTile(h).getSize();
     }
-    averageScale.x /= selectedTileIndices.size();
-    averageScale.y /= selectedTileIndices.size();
+    averageScale.x /= selectedTiles.size();
+    averageScale.y /= selectedTiles.size();
 
     sf::Vector2f newScale = averageScale;
     if (ImGui::DragFloat2("Scale", &newScale.x, 0.1f, 0.01f, 1000.0f, "%.3f")) {
+        selectionEdited = true;
         sf::Vector2f deltaScale = newScale - averageScale;
-        for (int idx : selectedTileIndices) {
-            sf::Vector2f currentScale = tiles[idx]->getSize();
-            tiles[idx]->setSize(currentScale + deltaScale);
+        for (Handle h : selectedTiles) {
+            sf::Vector2f currentScale = getTile(h).getSize();
+            getTile(h).setSize(currentScale + deltaScale);
         }
     }
     if (ImGui::IsItemHovered())
@@ -568,15 +927,16 @@ void TileManager::displayTileScales() {
 
 void TileManager::displayTileProperties(Tiles& tile) 
 {
-    if (selectedTileIndices.empty() || !allTilesHaveSameTag()) return;
+    if (selectedTiles.empty() || !allTilesHaveSameTag()) return;
 
-    auto& firstTile = *tiles[*selectedTileIndices.begin()];
+    auto& firstTile = getTile(selectedTiles.front());
 
     char buffer[256];
     strcpy_s(buffer, firstTile.getTag().c_str());
     if (ImGui::InputText("Tag", buffer, sizeof(buffer))) {
-        for (int idx : selectedTileIndices) {
-            tiles[idx]->setTag(std::string(buffer));
+        selectionEdited = true;
+        for (Handle h : selectedTiles) {
+            getTile(h).setTag(std::string(buffer));
         }
     }
     if (ImGui::IsItemActive())
@@ -605,10 +965,10 @@ void TileManager::displayTileProperties(Tiles& tile)
 
 
 bool TileManager::allTilesHaveSameTag() {
-    if (selectedTileIndices.size() < 2) return true;
-    std::string firstTag = tiles[*selectedTileIndices.begin()]->getTag();
-    for (auto idx : selectedTileIndices) {
-        if (tiles[idx]->getTag() != firstTag) return false;
+    if (selectedTiles.size() < 2) return true;
+    std::string firstTag = getTile(selectedTiles.front()).getTag();
+    for (Handle h : selectedTiles) {
+        if (getTile(h).getTag() != firstTag) return false;
     }
     return true;
 }
@@ -616,18 +976,19 @@ bool TileManager::allTilesHaveSameTag() {
 void TileManager::displayCheckBox(const char* label, bool& value) {
     bool currentValue = value;
     if (ImGui::Checkbox(label, &currentValue)) {
-        for (int idx : selectedTileIndices) {
+        selectionEdited = true;
+        for (Handle h : selectedTiles) {
             if (strcmp(label, "Trigger") == 0) {
-                tiles[idx]->setTrigger(currentValue);
+                getTile(h).setTrigger(currentValue);
             }
             else if (strcmp(label, "Static") == 0) {
-                tiles[idx]->setStatic(currentValue);
+                getTile(h).setStatic(currentValue);
             }
             else if (strcmp(label, "Massless") == 0) {
-                tiles[idx]->setMassless(currentValue);
+                getTile(h).setMassless(currentValue);
             }
             else if (strcmp(label, "Tile") == 0) {
-                tiles[idx]->setTile(currentValue);
+                getTile(h).setTile(currentValue);
             }
         }
     }
@@ -650,22 +1011,124 @@ void TileManager::displayCheckBox(const char* label, bool& value) {
 void TileManager::addNewTile() {
     auto newTile = std::make_unique<Tiles>();
     newTile->setPosition(0, 0);  // Default position
-    world->AddGameObject(*newTile);
-    tiles.push_back(std::move(newTile));
-    selectedTileIndices.clear();
-    selectedTileIndices.insert(tiles.size() - 1);
+    Tiles& tile = addTile(std::move(newTile));
+    journalAdd(tile);
+    clearSelection();
+    selectTile(tile);
 }
 
 void TileManager::deleteSelectedTiles() {
-    std::vector<int> sortedIndices(selectedTileIndices.begin(), selectedTileIndices.end());
-    std::sort(sortedIndices.rbegin(), sortedIndices.rend());
-    for (int idx : sortedIndices) {
-        world->RemoveGameObject(*tiles[idx]);
-        tiles.erase(tiles.begin() + idx);
+    std::vector<Handle> doomed;
+    doomed.swap(selectedTiles);
+    removeTiles(doomed);
+}
+
+Tiles& TileManager::addTile(std::unique_ptr<Tiles> tile) {
+    tile->setTileHandle(tileHandles.allocate((uint32_t)tiles.size()));
+    // Tiles showing the placeholder are indexed by texture name, so updateTextures only visits those
+    if (tile->getTexture() == textureManager.getPlaceholder()) {
+        tilesAwaitingTexture[tile->getTextureName()].push_back(tile->getTileHandle());
+    }
+    if (!streaming) world->AddGameObject(*tile); // Streamed chunks provide the play tiles
+    tiles.push_back(std::move(tile));
+    return *tiles.back();
+}
+
+// Each tile is swapped with the last one and popped, and its handle released, so the cost is per removed tile
+// rather than per tile left behind. Handles to the tiles that moved stay valid.
+void TileManager::removeTiles(const std::vector<Handle>& handles, std::vector<std::unique_ptr<Tiles>>* keep) {
+    std::vector<GameObject*> removed;
+    removed.reserve(handles.size());
+    for (Handle h : handles) {
+        if (!tileHandles.isAlive(h)) continue;
+        Tiles& tile = getTile(h);
+        staticLayer.markDirty(tile.getGlobalBounds());
+        if (keep) {
+            journalSnapshots.erase(tile.getJournalId());
+        }
+        else {
+            journalDelete(tile);
+        }
+        removed.push_back(&tile);
+    }
+    world->RemoveGameObjects(removed);
+
+    bool selectionChanged = false;
+    for (Handle h : handles) {
+        if (!tileHandles.isAlive(h)) continue; // Listed twice
+        uint32_t index = tileHandles.getDense(h);
+        selectionChanged |= tiles[index]->isSelected();
+        if (keep) {
+            tiles[index]->setSelected(false);
+            tiles[index]->setEditing(false);
+            keep->push_back(std::move(tiles[index]));
+        }
+        if (index != tiles.size() - 1) {
+            tiles[index] = std::move(tiles.back());
+            tileHandles.setDense(tiles[index]->getTileHandle(), index);
+        }
+        tiles.pop_back();
+        tileHandles.release(h);
+    }
+
+    // Drop removed tiles from the selection, keeping the order of the rest
+    if (selectionChanged) {
+        selectedTiles.erase(std::remove_if(selectedTiles.begin(), selectedTiles.end(),
+            [this](Handle h) { return !tileHandles.isAlive(h); }), selectedTiles.end());
     }
-    selectedTileIndices.clear();
 }
 
+void TileManager::restoreCollectables() {
+    for (auto& tile : collectedTiles) {
+        Tiles& restored = addTile(std::move(tile));
+        updateTileColour(restored);
+        staticLayer.markDirty(restored.getGlobalBounds());
+    }
+    collectedTiles.clear();
+}
 
+void TileManager::selectTile(Tiles& tile) {
+    if (tile.isSelected()) return;
+    tile.setSelected(true);
+    tile.setEditing(true);
+    selectedTiles.push_back(tile.getTileHandle());
+    if (journalSnapshots.find(tile.getJournalId()) == journalSnapshots.end()) {
+        journalSnapshots[tile.getJournalId()] = { &tile, describeTile(tile) };
+    }
+    updateTileColour(tile);
+}
+
+void TileManager::deselectTile(Tiles& tile) {
+    if (!tile.isSelected()) return;
+    journalSelectedTiles(); // Record any edit before the tile stops being tracked
+    journalSnapshots.erase(tile.getJournalId());
+    tile.setSelected(false);
+    tile.setEditing(false);
+    selectedTiles.erase(std::find(selectedTiles.begin(), selectedTiles.end(), tile.getTileHandle()));
+    updateTileColour(tile);
+}
 
+void TileManager::clearSelection() {
+    journalSelectedTiles();
+    journalSnapshots.clear();
+    for (Handle h : selectedTiles) {
+        Tiles& tile = getTile(h);
+        tile.setSelected(false);
+        tile.setEditing(false);
+        updateTileColour(tile);
+    }
+    selectedTiles.clear();
+}
+
+void TileManager::updateTileColour(Tiles& tile) {
+    if (tile.isSelected()) {
+        tile.setColor(sf::Color::Green); // Highlight selected tiles
+    }
+    else if (tile.getTag() == "Wall") {
+        tile.setColor(sf::Color::Blue);
+    }
+    else {
+        tile.setColor(sf::Color::Red);
+    }
+}
 
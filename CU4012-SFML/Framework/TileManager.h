@@ -3,28 +3,62 @@
 #include "World.h"
 #include "Tiles.h"
 #include "TextureManager.h"
+#include "SpriteBatch.h"
+#include "DebugDraw.h"
+#include "StaticLayerCache.h"
+#include "RenderBackend.h"
+#include "LevelStreamer.h"
+#include "EditJournal.h"
 #include <fstream>
 #include <vector>
 #include <string>
 #include <sstream> // This is required for std::stringstream
-#include <set>     // For selecting multiple tiles
 
 class TileManager : public GameObject
 {
-    std::set<int> selectedTileIndices; // Set to keep track of selected tile indices
+    // Handles of the selected tiles in the order they were selected. Each tile also carries its own selected flag,
+    // so membership checks are a flag test and the list only has to be walked to act on the selection.
+    std::vector<Handle> selectedTiles;
     bool recentlyCleared = false; // Used to prevent multiple tiles from being selected at once
     int activeTileIndex = -1; // -1 indicates no tile is actively being edited
     bool tilesLoaded = false;
     //std::vector<Tiles> tiles;
 
+    // Unordered, tiles are removed by swap-and-pop. Hold a handle rather than an index to refer to a tile.
     std::vector<std::unique_ptr<Tiles>> tiles;
+    HandleTable tileHandles;
+    // Collectables picked up in play. Out of the World and the tiles vector, but still saved with the level.
+    std::vector<std::unique_ptr<Tiles>> collectedTiles;
     
     TextureManager textureManager;
+    std::unordered_map<std::string, std::vector<Handle>> tilesAwaitingTexture; // Tiles given the placeholder, by texture name
+    std::vector<std::string> readyTextures; // Uploaded, but not yet put on all their waiting tiles
+    SpriteBatch spriteBatch;
+    DebugDraw debugDraw;
+    DebugDraw tileOutlines; // Edit mode tile boxes. Part of the editor, so always enabled, unlike debugDraw.
+    StaticLayerCache staticLayer; // Static tiles pre-rendered for play mode
+    LevelStreamer streamer; // Chunks near the view, when streaming is enabled
+    bool streaming = false;
+    // Chunks the editor has changed since they were last written. Saving rewrites them from the resident tiles.
+    std::unordered_set<int64_t> dirtyChunks;
+    bool allChunksDirty = false; // Loaded with journal edits the chunks may not have
+
+    // Edits are appended to the journal as they happen; saving compacts it into the level file in the background
+    EditJournal journal;
+    unsigned int nextTileId = 0;
+    struct JournalSnapshot
+    {
+        Tiles* tile;
+        LevelTile state; // As last written to the journal
+    };
+    std::unordered_map<unsigned int, JournalSnapshot> journalSnapshots; // Selected tiles, kept in step by the selection functions
+    bool selectionEdited = false; // Set by the edit paths, the snapshots are only compared on frames where it is set
 
     std::string filePath; // File to store tile data
 
     World* world;
     sf::View* view;
+    RenderBackend* renderer;
 
     bool showDebugCollisionBox;
 
@@ -40,20 +74,44 @@ public:
     void update(float dt) override;
     void handleInput(float dt) override;
     void render(bool editMode);
+    // Upload textures finished in the background and put them on the tiles that were waiting for them
+    void updateTextures();
 
     void saveTiles(const std::vector<std::unique_ptr<Tiles>>& tiles, const std::string& filePath);
     bool loadTiles();
+    // Free the resident tiles. Edits must have been saved or journalled first.
+    void unloadTiles();
+    bool areTilesLoaded() { return tilesLoaded; }
+    // Called on entering and leaving the editor. While streaming the resident tiles are only loaded in between.
+    void beginEditing();
+    void endEditing();
+    // Write the level file from the current tiles on a background thread. Edits are already safe in the journal.
+    void saveLevel();
+    // Finish background saves and start one when the journal gets long. Call once per frame.
+    void updateJournal();
 
     std::vector<std::unique_ptr<Tiles>>& getTiles();
 
     void setWorld(World* world) { this->world = world; }
     void setView(sf::View* view) { this->view = view; }
+    void setRenderer(RenderBackend* renderer) { this->renderer = renderer; }
 
     std::string getFilePath() { return filePath; }
+    // Level to load and save, TilesData.txt by default. A .lvl extension selects the binary format. Set before loadTiles().
+    void setFilePath(const std::string& path) { filePath = path; }
 
     void RemoveCollectable();
 
-    void ShowDebugCollisionBox(bool b) { showDebugCollisionBox = b; }
+    // Streaming mode plays a level split into chunks (see LevelStreamer) instead of the resident tiles. Off by default,
+    // Main turns it on with --stream. The resident tiles are then only loaded in the editor, and never join the World.
+    bool buildStreamingChunks(const std::string& chunkDirectory) { return LevelStreamer::buildChunks(filePath, chunkDirectory); }
+    bool enableStreaming(const std::string& chunkDirectory);
+    void disableStreaming();
+    bool isStreaming() { return streaming; }
+    void updateStreaming(const sf::View& view) { if (streaming) streamer.update(view); }
+
+    void ShowDebugCollisionBox(bool b) { showDebugCollisionBox = b; debugDraw.setEnabled(b); }
+    DebugDraw* getDebugDraw() { return &debugDraw; }
 
     void DrawImGui();
 
@@ -69,4 +127,33 @@ public:
     void displayCheckBox(const char* label, bool& value);
     void addNewTile();
     void deleteSelectedTiles();
+
+private:
+    bool loadCsvTiles();
+    bool loadBinaryTiles();
+    bool loadJournalledTiles();
+
+    LevelTile describeTile(Tiles& tile);
+    void journalAdd(Tiles& tile);
+    void journalDelete(Tiles& tile);
+    void markChunkDirty(const sf::FloatRect& bounds);
+    void writeDirtyChunks(const std::vector<LevelTile>& level);
+    // Write a modify record for every selected tile that changed since it was last journalled
+    void journalSelectedTiles();
+    // Snapshot the selected tiles again, after their journal ids have changed
+    void resetJournalSnapshots();
+
+    // Every tile goes in and out through these so the handle table stays in step with the vector and the World
+    Tiles& addTile(std::unique_ptr<Tiles> tile);
+    // Removed tiles are journalled as deletes, unless keep is given. Then they are moved there and the level is unchanged.
+    void removeTiles(const std::vector<Handle>& handles, std::vector<std::unique_ptr<Tiles>>* keep = nullptr);
+    void restoreCollectables();
+    Tiles& getTile(Handle h) { return *tiles[tileHandles.getDense(h)]; }
+
+    // Selection changes go through these so the flags, the list and the tile colours stay in step
+    void selectTile(Tiles& tile);
+    void deselectTile(Tiles& tile);
+    void clearSelection();
+    // Green when selected, otherwise by tag. Only needs calling when either changes.
+    void updateTileColour(Tiles& tile);
 };
\ No newline at end of file
@@ -12,17 +12,24 @@ TileMap::~TileMap()
 
 // Uses window pointer to render level/section. Tile by Tile.
 void TileMap::render(sf::RenderWindow* window)
+{
+	SFMLRenderBackend backend(window);
+	render(&backend);
+}
+
+// Uses the render backend to render level/section. Tile by Tile.
+void TileMap::render(RenderBackend* renderer)
 {
 	for (int i = 0; i < (int)level.size(); i++)
 	{
-		window->draw(level[i]);
+		renderer->draw(level[i]);
 	}
 }
 
 // Loads and stores the spritesheet containing all the tiles required to build the level/section
 void TileMap::loadTexture(const char* filename)
 {
-	texture.loadFromFile(filename);
+	texture = AssetCache::get().getTexture(filename);
 }
 
 // Receives an array of GameObjects representing the tile set (in order)
@@ -52,7 +59,7 @@ void TileMap::buildLevel()
 			y = (int)floor(i / mapSize.x);
 			tileSet[tileMap[i]].setPosition(position.x + (x * tileSize.x), position.y + (y * tileSize.y));
 			level.push_back(tileSet[tileMap[i]]);
-			level[i].setTexture(&texture);
+			level[i].setTexture(texture.get());
 		}
 	}
 }
\ No newline at end of file
@@ -5,6 +5,8 @@
 #pragma once
 #include <math.h>
 #include "GameObject.h"
+#include "RenderBackend.h"
+#include "AssetCache.h"
 
 class TileMap
 {
@@ -23,6 +25,8 @@ public:
 
 	// Receives window handle and renders the level/tilemap
 	void render(sf::RenderWindow* window);
+	// Renders the level/tilemap through a render backend
+	void render(RenderBackend* renderer);
 	// Returns the built level tile map. Used for collision detection, etc, where we need access to elements of the level.
 	std::vector<GameObject>* getLevel(){ return &level; };
 
@@ -33,7 +37,7 @@ protected:
 	std::vector<GameObject> tileSet;
 	std::vector<int> tileMap;
 	std::vector<GameObject> level;
-	sf::Texture texture;
+	std::shared_ptr<sf::Texture> texture;
 	sf::Vector2u mapSize;
 	sf::Vector2f position;
 };
@@ -4,6 +4,9 @@ class Tiles :
     public GameObject
 {
     bool editing; // To track editing mode
+    bool selected = false; // Selected in the editor, kept in step with TileManager's selection list
+    unsigned int journalId = 0; // Identifies the tile in the edit journal
+    Handle tileHandle; // Slot in the TileManager's handle table
 public:
     Tiles();
 
@@ -15,5 +18,11 @@ public:
     bool isEditing() {
 		return editing;
 	}
+    void setSelected(bool s) { selected = s; }
+    bool isSelected() const { return selected; }
+    void setJournalId(unsigned int id) { journalId = id; }
+    unsigned int getJournalId() { return journalId; }
+    void setTileHandle(Handle h) { tileHandle = h; }
+    Handle getTileHandle() const { return tileHandle; }
 };
 
@@ -5,14 +5,47 @@ World::World()
 {
 }
 
-void World::AddGameObject(GameObject& obj)
+Handle World::AddGameObject(GameObject& obj)
 {
+    if (getGameObject(obj.getWorldHandle()) == &obj) {
+        return obj.getWorldHandle();
+    }
+    Handle h = handles.allocate((uint32_t)objects.size());
     objects.push_back(&obj);
+    bodies.push_back(obj.getBodyHandle());
+    obj.setWorldHandle(h);
+    return h;
 }
 
 void World::RemoveGameObject(GameObject& obj)
 {
-    objects.remove(&obj);
+    // A copied object carries the handle of the original, so check it really is this object
+    Handle h = obj.getWorldHandle();
+    if (getGameObject(h) != &obj) return;
+
+    uint32_t index = handles.getDense(h);
+    GameObject* last = objects.back();
+    objects[index] = last;
+    bodies[index] = bodies.back();
+    handles.setDense(last->getWorldHandle(), index);
+    objects.pop_back();
+    bodies.pop_back();
+
+    handles.release(h);
+    obj.setWorldHandle(Handle());
+}
+
+void World::RemoveGameObjects(const std::vector<GameObject*>& objs)
+{
+    for (GameObject* obj : objs) {
+        if (obj) RemoveGameObject(*obj);
+    }
+}
+
+GameObject* World::getGameObject(Handle h) const
+{
+    if (!handles.isAlive(h)) return nullptr;
+    return objects[handles.getDense(h)];
 }
 
 void World::UpdatePhysics(float deltaTime)
@@ -25,21 +58,36 @@ void World::UpdatePhysics(float deltaTime)
 
     // Apply gravity to all non-static objects and update their physics
     for (auto& obj : objects) {
-        // Update object physics
         obj->UpdatePhysics(&gravity, deltaTime);
         obj->update(deltaTime);
     }
+
     // Handle collision checks
-    for (auto it1 = objects.begin(); it1 != objects.end(); ++it1) {
-        for (auto it2 = std::next(it1); it2 != objects.end(); ++it2) {
-            if ((*it1)->checkCollision(*it2)) {
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        for (size_t j = i + 1; j < bodies.size(); ++j) {
+            // Tiles never collide with each other, and boxes that don't overlap can't collide
+            const PhysicsBody& a = PhysicsBodyTable::get(bodies[i]);
+            const PhysicsBody& b = PhysicsBodyTable::get(bodies[j]);
+            if ((a.flags & PhysicsBody::TILE) && (b.flags & PhysicsBody::TILE)) continue;
+            if (!a.aabb.intersects(b.aabb)) continue;
+
+            GameObject* obj1 = objects[i];
+            GameObject* obj2 = objects[j];
+            if (obj1->checkCollision(obj2)) {
                 // Call collision response here if needed
                 //std::cout << "Collision is happening\n";
-                (*it1)->collisionResponse(*it2);
-                (*it2)->collisionResponse(*it1);
+                obj1->collisionResponse(obj2);
+                obj2->collisionResponse(obj1);
+
+                // Mark the centre of the overlap as the contact point
+                if (debugDraw && debugDraw->isEnabled()) {
+                    sf::FloatRect overlap;
+                    // Fetched again, as a response may have created objects and moved the table
+                    if (PhysicsBodyTable::get(bodies[i]).aabb.intersects(PhysicsBodyTable::get(bodies[j]).aabb, overlap)) {
+                        debugDraw->addPoint(sf::Vector2f(overlap.left + overlap.width / 2, overlap.top + overlap.height / 2), sf::Color::Yellow);
+                    }
+                }
             }
         }
     }
 }
-
-
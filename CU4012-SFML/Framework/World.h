@@ -1,19 +1,34 @@
 #pragma once
 #include <iostream>
 #include <SFML/Graphics.hpp>
-#include <list>
+#include <vector>
 #include "GameObject.h"
+#include "DebugDraw.h"
 
 class World
 {
-	std::list<GameObject*> objects; // becomes ptrs internally but never exposed
+	// Packed so removal is a swap-and-pop. The handle table maps each object's world handle to its position here
+	std::vector<GameObject*> objects; // becomes ptrs internally but never exposed
+	HandleTable handles;
 	sf::Vector2f gravity;
+	DebugDraw* debugDraw = nullptr; // Optional, receives contact points when enabled
+
+	// Handle of each object's PhysicsBody, at the same position as the object. The pair loop rejects pairs by
+	// reading the bodies straight out of the PhysicsBodyTable and only touches the objects that overlap.
+	std::vector<ObjectHandle> bodies;
 
 public:
 	World();
 	void setGravity(sf::Vector2f g) { gravity = g; }
-	void AddGameObject(GameObject& obj);
+	void setDebugDraw(DebugDraw* dd) { debugDraw = dd; }
+	// Returns the object's world handle. Adding an object that is already in the world returns its existing handle
+	Handle AddGameObject(GameObject& obj);
+	// O(1), but doesn't keep the update order of the remaining objects
 	void RemoveGameObject(GameObject& obj);
+	void RemoveGameObjects(const std::vector<GameObject*>& objs);
+	// Null if the object has been removed since the handle was given out
+	GameObject* getGameObject(Handle h) const;
+	int getObjectCount() const { return (int)objects.size(); }
 	void UpdatePhysics(float deltaTime);
 };
 
@@ -9,13 +9,17 @@ Level::Level(sf::RenderWindow* hwnd, Input* in, GameState* gs,sf::View* v, World
 	tileManager = tm;
 	audioManager = new AudioManager();
 
-	audioManager->addMusic("sfx/Cantina.ogg", "bgm");
+	menuMusic = audioManager->addMusic("sfx/hyrulefield.ogg", "menu");
+	levelMusic = audioManager->addMusic("sfx/Cantina.ogg", "bgm");
+	currentMusic = InvalidAudioId;
 	audioManager->addSound("sfx/smb_jump-super.wav", "jump");
+#ifdef _DEBUG
+	audioManager->printReport(); // Load modes and memory use, for tuning the audio load policy
+#endif
 	
 	mario.setInput(input);
 	mario.setAudio(audioManager);
-
-	audioManager->playMusicbyName("bgm");
+	mario.setAnimationSystem(&animations);
 
 	//world->AddGameObject(zomb);
 	world->AddGameObject(mario);
@@ -40,11 +44,11 @@ void Level::handleInput(float dt)
 {
 	if (input->isKeyDown(sf::Keyboard::Escape))
 	{
-		exit(0);
+		window->close(); // Ends the game loop, so assets are freed before main returns
 	}
-	if (input->isKeyDown(sf::Keyboard::Tab))
+	if (input->isPressed(sf::Keyboard::Tab))
 	{
-		input->setKeyUp(sf::Keyboard::Tab);
+		tileManager->beginEditing();
 		gameState->setCurrentState(State::TILEEDITOR);
 	}
 	mario.handleInput(dt);
@@ -53,6 +57,7 @@ void Level::handleInput(float dt)
 // Update game objects
 void Level::update(float dt)
 {
+	animations.update(dt);
 
 	//Move the view to follow the player
 	view->setCenter(view->getCenter().x, 360);
@@ -60,17 +65,41 @@ void Level::update(float dt)
 	float newX = std::max(playerPosition.x, view->getSize().x / 2.0f);
 view->setCenter(newX, view->getCenter().y);
 	window->setView(*view);
+
+	// Load and unload level chunks around the new view (does nothing unless streaming is enabled)
+	tileManager->updateStreaming(*view);
+}
+
+void Level::updateAudio(float dt)
+{
+	audioManager->setListenerPosition(view->getCenter());
+
+	// The track not playing is kept open on the idle stream, so switching between menu and level is instant
+	bool inMenu = gameState->getCurrentState() == State::MENU;
+	MusicId track = inMenu ? menuMusic : levelMusic;
+	if (track != currentMusic)
+	{
+		audioManager->playMusic(track, 1.5f);
+		currentMusic = track;
+	}
+	else
+	{
+		audioManager->prefetchMusic(inMenu ? levelMusic : menuMusic);
+	}
+	audioManager->update(dt);
 }
 
 // Render level
 void Level::render()
 {
+	renderer->setView(*view);
 	if (gameState->getCurrentState() == State::LEVEL)
 	{
 		tileManager->render(false);
 	}
 	// Render level
-	window->draw(mario);
+	spriteBatch.submit(mario);
+	spriteBatch.flush(*renderer);
 
 
 }
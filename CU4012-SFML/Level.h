@@ -7,6 +7,8 @@
 #include "Framework/World.h"
 #include "Framework/TileManager.h"
 #include "Framework/AudioManager.h"
+#include "Framework/SpriteBatch.h"
+#include "Framework/AnimationSystem.h"
 #include <string>
 #include <iostream>
 #include "Mario.h"
@@ -19,9 +21,21 @@ public:
 	void handleInput(float dt) override;
 	void update(float dt) override;
 	void render();
+	// Picks the menu or level track for the current state and updates the audio. Runs every frame, in any state.
+	void updateAudio(float dt);
 	void adjustViewToWindowSize(unsigned int width, unsigned int height);
 private:
 	// Default variables for level class.
-	
+
+	// Shared clips and playback state for every animated object. Declared before them so it outlives them.
+	AnimationSystem animations;
+
 	Mario mario;
+
+	MusicId menuMusic;
+	MusicId levelMusic;
+	MusicId currentMusic;
+
+	// Dynamic game objects are submitted here every frame and drawn together
+	SpriteBatch spriteBatch;
 };
\ No newline at end of file
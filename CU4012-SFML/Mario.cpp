@@ -1,66 +1,89 @@
 #include "Mario.h"
+#include "Framework/SpriteSheet.h"
 
 Mario::Mario()
 {
 	speed = 200;
 
-	marioSpriteSheet.loadFromFile("gfx/MarioSheetT.png");
 	setSize(sf::Vector2f(15*4, 21*4));
 	setPosition(100, 100);
-	setTexture(&marioSpriteSheet);
 
+	animations = nullptr;
+	animation = InvalidAnimation;
+	walk = swim = duck = InvalidClip;
+	jumpSound = InvalidAudioId;
+}
 
-	walk.addFrame(sf::IntRect(0, 0, 15, 21)); 
-	walk.addFrame(sf::IntRect(15, 0, 15, 21)); 
-	walk.addFrame(sf::IntRect(30, 0, 15, 21)); 
-	walk.addFrame(sf::IntRect(45, 0, 15, 21));  
-	walk.setFrameSpeed(1.f / 10.f); 
+Mario::~Mario()
+{
+	if (animations != nullptr)
+	{
+		animations->destroy(animation);
+	}
+}
 
-	swim.addFrame(sf::IntRect(0, 21, 16, 20));
-	swim.addFrame(sf::IntRect(16, 21, 16, 20));
-	swim.addFrame(sf::IntRect(32, 21, 16, 20));
-	swim.setFrameSpeed(1.f / 4.f);
+void Mario::setAnimationSystem(AnimationSystem* anims)
+{
+	if (animations != nullptr)
+	{
+		animations->destroy(animation);
+	}
+	animations = anims;
+
+	const SpriteSheet* sheet = animations->loadSpriteSheet("gfx/MarioSheetT.sheet");
+	if (sheet == nullptr)
+	{
+		animations = nullptr;
+		return;
+	}
+	setTexture(sheet->getTexture());
 
-	duck.addFrame(sf::IntRect(0, 44, 17, 17));
-	//duck.addFrame(sf::IntRect(17, 44, 17, 17));
-	duck.setFrameSpeed(1.f / 2.f);
+	walk = animations->findClip("mario_walk");
+	swim = animations->findClip("mario_swim");
+	duck = animations->findClip("mario_duck");
 
-	currentAnimation = &walk;
+	animation = animations->create(walk);
 }
 
 void Mario::handleInput(float dt)
 {
-	velocity.x = 0.f;
+	// Velocity lives in the physics body, so only the horizontal part is replaced
+	float moveX = 0.f;
 
-	setTextureRect(currentAnimation->getCurrentFrame());
+	// animations is null if the sheet failed to load; Mario still moves, just without animating
+	if (animations) setTextureRect(animations->getFrame(animation));
 
+	ClipId clip = walk;
 	if (input->isKeyDown(sf::Keyboard::A))
 	{
-		velocity.x = -speed;
-		currentAnimation = &walk;
-		currentAnimation->setFlipped(true);
+		moveX = -speed;
+		if (animations) animations->setFlipped(animation, true);
 	}
 	else if (input->isKeyDown(sf::Keyboard::D))
 	{
-		velocity.x = speed;
-		currentAnimation = &walk;
-		currentAnimation->setFlipped(false);
+		moveX = speed;
+		if (animations) animations->setFlipped(animation, false);
 	}
 	else if(input->isKeyDown(sf::Keyboard::S))
 	{
-		currentAnimation = &duck;
+		clip = duck;
 	}
-	else
+	else if (animations)
 	{
-		currentAnimation->reset();
-		currentAnimation = &walk;
+		animations->reset(animation);
 	}
 
-	if (input->isKeyDown(sf::Keyboard::Space) && canJump)
+	if (animations) animations->play(animation, clip);
+	setVelocity(moveX, getVelocity().y);
+
+	// isPressed also catches a tap shorter than a frame, which isKeyDown misses
+	if ((input->isKeyDown(sf::Keyboard::Space) || input->isPressed(sf::Keyboard::Space)) && canJump)
 	{
 		Jump(200.f);
-		audio->playSoundbyName("jump");
+		if (audio)
+		{
+			if (jumpSound == InvalidAudioId) jumpSound = audio->findSound("jump");
+			audio->playSoundAt(jumpSound, getPosition());
+		}
 	}
-
-	currentAnimation->animate(dt);
 }
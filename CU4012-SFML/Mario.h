@@ -1,18 +1,21 @@
 #pragma once
 #include "Framework/GameObject.h"
-#include "Framework/Animation.h"
+#include "Framework/AnimationSystem.h"
 
 class Mario : public GameObject
 {
 	int speed;
-	sf::Texture marioSpriteSheet;
-	Animation walk;
-	Animation swim;
-	Animation duck;
-	Animation* currentAnimation;
+	AnimationSystem* animations;
+	AnimationHandle animation;
+	ClipId walk;
+	ClipId swim;
+	ClipId duck;
+	SoundId jumpSound; // Looked up on the first jump
 	
 public:
 	Mario();
+	~Mario();
+	// Loads Mario's sprite sheet into the system and creates this instance's playback state
+	void setAnimationSystem(AnimationSystem* anims);
 	void handleInput(float dt) override;
 };
-
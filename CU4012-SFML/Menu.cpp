@@ -7,12 +7,12 @@ Menu::Menu(sf::RenderWindow* hwnd, Input* in, GameState* game)
 	gameState = game;
 
 
-	UIfont.loadFromFile("font/ZOMBIES REBORN.ttf");
-	titleFont.loadFromFile("font/BloodBlocks Project.ttf");
+	UIfont = AssetCache::get().getFont("font/ZOMBIES REBORN.ttf");
+	titleFont = AssetCache::get().getFont("font/BloodBlocks Project.ttf");
 
 
-	menu_texture.loadFromFile("gfx/menu.png");
-	menu_sprite.setTexture(menu_texture);
+	menu_texture = AssetCache::get().getTexture("gfx/menu.png");
+	if (menu_texture) menu_sprite.setTexture(*menu_texture);
 	
 	//Scaling the sprite to fit any screen 
 	auto bounds = menu_sprite.getLocalBounds();
@@ -28,7 +28,7 @@ Menu::Menu(sf::RenderWindow* hwnd, Input* in, GameState* game)
 	menu_sprite.setScale(uniformScale, uniformScale);
 
 
-	Title.setFont(titleFont);
+	if (titleFont) Title.setFont(*titleFont);
 	Title.setFillColor(sf::Color::Magenta);
 	Title.setString("My Game");
 	Title.setOutlineColor(sf::Color::Black);
@@ -36,7 +36,7 @@ Menu::Menu(sf::RenderWindow* hwnd, Input* in, GameState* game)
 	Title.setPosition(500, 50);
 
 
-	UIText[0].text.setFont(UIfont);
+	if (UIfont) UIText[0].text.setFont(*UIfont);
 	UIText[0].text.setFillColor(sf::Color::Red);
 	UIText[0].text.setString("Play");
 	UIText[0].text.setPosition(sf::Vector2f(600,120));
@@ -44,7 +44,7 @@ Menu::Menu(sf::RenderWindow* hwnd, Input* in, GameState* game)
 
 
 
-	UIText[1].text.setFont(UIfont);
+	if (UIfont) UIText[1].text.setFont(*UIfont);
 	UIText[1].text.setFillColor(sf::Color::White);
 	UIText[1].text.setString("Exit");
 	UIText[1].text.setPosition(sf::Vector2f(600,150));
@@ -129,18 +129,16 @@ void Menu::MoveDown()
 void Menu::handleInput(float dt)
 {
 	// Keyboard handling for menu navigation
-	if (input->isKeyDown(sf::Keyboard::Up)) {
+	if (input->isPressed(sf::Keyboard::Up)) {
 		MoveUp();
-		input->setKeyUp(sf::Keyboard::Up);
 	}
 
-	if (input->isKeyDown(sf::Keyboard::Down)) {
+	if (input->isPressed(sf::Keyboard::Down)) {
 		MoveDown();
-		input->setKeyUp(sf::Keyboard::Down);
 	}
 
 	// Execute action for the current selected item
-	if (input->isKeyDown(sf::Keyboard::Enter) || (input->isLeftMouseDown() && mouseOverAnyItem)) {
+	if (input->isPressed(sf::Keyboard::Enter) || (input->isLeftMousePressed() && mouseOverAnyItem)) {
 		switch (selectedItem) {
 		case 0:
 			std::cout << "Play Button has been pressed" << std::endl;
@@ -148,34 +146,26 @@ void Menu::handleInput(float dt)
 			break;
 		case 1:
 			std::cout << "Exit Button has been pressed" << std::endl;
-			exit(0);
+			window->close(); // Ends the game loop, so assets are freed before main returns
 			break;
 		}
-
-		// Reset input states
-		if (input->isKeyDown(sf::Keyboard::Enter)) {
-			input->setKeyUp(sf::Keyboard::Enter);
-		}
-		if (input->isLeftMouseDown()) {
-			input->setLeftMouse(Input::MouseState::UP); // Assuming you have a method to reset the mouse state
-		}
 	}
 
 }
 
 void Menu::render()
 {
-	window->draw(menu_sprite);
-	window->draw(Title);
+	renderer->draw(menu_sprite);
+	renderer->draw(Title);
 	for (int i = 0; i < 2; i++)
 	{
-		window->draw(UIText[i].text);
+		renderer->draw(UIText[i].text);
 	}
 
 	//Uncomment so debug shapes for the menu text
 	//for (int i = 0; i < 2; i++)
 	//{
-	//	window->draw(UIText[i].getDebugShape());
+	//	renderer->draw(UIText[i].getDebugShape());
 	//}
 
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "Framework/GameState.h"
 #include"Framework/Collision.h"
 #include "Framework/UI.h"
+#include "Framework/AssetCache.h"
 #include <string>
 #include <iostream>
 #include"Level.h"
@@ -31,8 +32,8 @@ public:
 	GameState* gameState;
 
 	int selectedItem;
-	sf::Font UIfont;
-	sf::Font titleFont;
+	std::shared_ptr<sf::Font> UIfont;
+	std::shared_ptr<sf::Font> titleFont;
 
 	sf::Text Title;
 	UI UIText[2];
@@ -42,7 +43,7 @@ public:
 
 
 	sf::Sprite menu_sprite;
-	sf::Texture menu_texture;
+	std::shared_ptr<sf::Texture> menu_texture;
 
 	sf::Vector2i MousePos;
 
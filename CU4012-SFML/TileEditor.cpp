@@ -6,20 +6,26 @@
 TileEditor::TileEditor(sf::RenderWindow* hwnd, Input* in, GameState* game, sf::View* v, World* w, TileManager* tm)
 {
 	window = hwnd;
+	renderer = nullptr;
 	input = in;
 	gameState = game;
 	view = v;
 	world = w;
 	tileManager = tm;
-	if (!font.loadFromFile("font/arial.ttf")) {
+	font = AssetCache::get().getFont("font/arial.ttf");
+	if (!font) {
 		std::cout << "error loading font" << std::endl;
 	};
 
-	if (!mouseCurosorTex.loadFromFile("gfx/cursor-grabbed.png"))
+	mouseCurosorTex = AssetCache::get().getTexture("gfx/cursor-grabbed.png");
+	if (!mouseCurosorTex)
 	{
 		std::cout << "Error loading cursor texture\n";
 	}
-	mouseCurosorGrab.setTexture(mouseCurosorTex);
+	else
+	{
+		mouseCurosorGrab.setTexture(*mouseCurosorTex);
+	}
 
 	// Set up tile manager
 	tileManager->setInput(input);
@@ -27,14 +33,19 @@ TileEditor::TileEditor(sf::RenderWindow* hwnd, Input* in, GameState* game, sf::V
 	tileManager->setWorld(world);
 	tileManager->setView(view);
 	tileManager->ShowDebugCollisionBox(true);
+	world->setDebugDraw(tileManager->getDebugDraw());
 
-	if (!tileManager->loadTiles())
-	{
-		std::cout << "Tiles not found\n";
-	}
-	else
+	// When streaming the level is only loaded once the editor is entered
+	if (!tileManager->isStreaming())
 	{
-		std::cout << "Tiles loaded\n";
+		if (!tileManager->loadTiles())
+		{
+			std::cout << "Tiles not found\n";
+		}
+		else
+		{
+			std::cout << "Tiles loaded\n";
+		}
 	}
 
 	originalViewSize = v->getSize(); // Store the original size of the view
@@ -47,20 +58,26 @@ TileEditor::~TileEditor()
 
 void TileEditor::handleInput(float dt)
 {
-	if (input->isKeyDown(sf::Keyboard::Tab))
+	// The switch happens at the end of the frame, so edits made later in this one are in the save
+	if (input->isPressed(sf::Keyboard::Tab))
 	{
-		input->setKeyUp(sf::Keyboard::Tab);
-		std::cout << "Exiting edit mode. Saving tiles...\n";
-		tileManager->saveTiles(tileManager->getTiles(), tileManager->getFilePath());
-		gameState->setCurrentState(State::LEVEL);
-
-		// Reset the view to the original size
-		view->setSize(originalViewSize);
-		view->setCenter(window->getSize().x / 2, window->getSize().y / 2);
-		view->zoom(1.0f);
+		exitRequested = true;
 	}
 }
 
+void TileEditor::exitEditMode()
+{
+	exitRequested = false;
+	std::cout << "Exiting edit mode. Saving tiles...\n";
+	tileManager->endEditing();
+	gameState->setCurrentState(State::LEVEL);
+
+	// Reset the view to the original size
+	view->setSize(originalViewSize);
+	view->setCenter(window->getSize().x / 2, window->getSize().y / 2);
+	view->zoom(1.0f);
+}
+
 void TileEditor::update(float dt)
 {
 	tileManager->handleInput(dt);
@@ -71,12 +88,13 @@ void TileEditor::update(float dt)
 
 void TileEditor::render()
 {
-	if(isDragging) window->draw(mouseCurosorGrab);
-	window->setView(*view);
+	if(isDragging) renderer->draw(mouseCurosorGrab);
+	renderer->setView(*view);
 	tileManager->render(true);
 
 	tileManager->DrawImGui();
 
+	if (exitRequested) exitEditMode();
 }
 
 void TileEditor::moveView(float dt)
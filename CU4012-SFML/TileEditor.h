@@ -5,6 +5,7 @@
 #include "Framework/GameState.h"
 #include "Framework/World.h"
 #include "Framework/TileManager.h"
+#include "Framework/AssetCache.h"
 #include <string>
 #include <iostream>
 
@@ -18,16 +19,22 @@ public:
 	void update(float dt);
 	void render();
 	void moveView(float dt);
+	void setRenderer(RenderBackend* r) { renderer = r; }
 private:
+	// Save and switch to the level. Called at the end of the frame Tab was pressed in, after the tile and ImGui edits.
+	void exitEditMode();
+	bool exitRequested = false;
+
 	// Default variables for level class.
 	sf::RenderWindow* window;
+	RenderBackend* renderer;
 	sf::View* view;
 	Input* input;
 	GameState* gameState;
 	World* world;
 
 	TileManager* tileManager;
-	sf::Font font;
+	std::shared_ptr<sf::Font> font;
 	
 	sf::Vector2f originalViewSize;
 
@@ -35,7 +42,7 @@ private:
 	float currentZoomLevel = 1.0f;
 	sf::Vector2i lastMousePos;
 	bool isDragging = false;
-	sf::Texture mouseCurosorTex;
+	std::shared_ptr<sf::Texture> mouseCurosorTex;
 	sf::Sprite mouseCurosorGrab;
 
 };